@@ -41,6 +41,27 @@
 
 #define AVRNTRU_MAX_DIM 743
 
+// The identifier AVRNTRU_LOG_Q has to be set to the binary logarithm of the
+// modulus q of the NTRU ring, which must be a power of two in [2^2, 2^16]. All
+// parameter sets of the EESS #1 standard use q = 2^11 = 2048. Since q divides
+// 2^16, the 16-bit arithmetic of the multiplications yields coefficients that
+// are correct modulo q even when they wrap around, i.e. the multiplications
+// can be chained in "lazy" fashion (without reduction of the coefficients) and
+// only the final consumer of a result needs to reduce it with AVRNTRU_Q_MASK.
+// The Assembler functions support only q = 2048. AVRNTRU_LOG_Q can also be
+// set on the command line of the compiler (e.g. -DAVRNTRU_LOG_Q=12).
+
+#ifndef AVRNTRU_LOG_Q
+#define AVRNTRU_LOG_Q 11
+#endif
+
+#define AVRNTRU_Q (1UL << AVRNTRU_LOG_Q)
+#define AVRNTRU_Q_MASK ((uint16_t) (AVRNTRU_Q - 1))
+
+#if (AVRNTRU_LOG_Q < 2) || (AVRNTRU_LOG_Q > 16)
+#error "AVRNTRU_LOG_Q must be in the range [2, 16]"
+#endif
+
 // The identifier AVRNTRU_USE_ASM determines whether AVRNTRU is compiled with
 // the AVR-assembler implementation or the ANSI C99 implementation of the ring
 // arithmetic and all other operations that are either performance-critical or
@@ -49,6 +70,18 @@
 
 #define AVRNTRU_USE_ASM
 
+// The identifier AVRNTRU_USE_SIMD determines whether AVRNTRU is compiled with
+// the vectorized implementation of the ring arithmetic on x86-64 platforms.
+// When the compiler targets a processor supporting AVX-512BW (e.g. gcc with
+// option -mavx512bw) then the AVX-512 version is used, otherwise, when the
+// target supports AVX2 (e.g. gcc with -mavx2), the AVX2 version is used. If
+// AVRNTRU_USE_SIMD is not defined, or the target supports neither AVX2 nor
+// AVX-512BW, the C99 version is used. Both vectorized versions produce exactly
+// the same results as the C99 version and require no changes of the operand
+// layout, i.e. arrays of length N+7 can be used as before.
+
+#define AVRNTRU_USE_SIMD
+
 // The identifier AVRNTRU_USE_VLA determines whether AVRNTRU is compiled with
 // Variable-Length Arrays (VLAs) or static arrays for the ring arithmetic (e.g.
 // temporary array <t> in ring_mul_tern_prodform) and other functions that are
@@ -64,6 +97,117 @@
 
 #define AVRNTRU_USE_VLA
 
+// The identifier AVRNTRU_SPECIALIZE determines whether the C99 version of the
+// ring arithmetic uses kernels that are specialized for the dimension N and
+// the number of non-0 coefficients of the sparse polynomials of EES401EP2,
+// EES443EP1, and EES743EP1 (e.g. ring_mul_tern_sparse_743_22_c99). These
+// kernels are generated from the same templates as the generic C99 functions,
+// but have loops of constant length that the compiler can completely unroll.
+// Other parameter sets are still supported through the generic functions. The
+// specialized kernels are not used when the Assembler version or a vectorized
+// version of the ring arithmetic is selected.
+
+#define AVRNTRU_SPECIALIZE
+
+// The identifier AVRNTRU_USE_SWAR determines whether AVRNTRU is compiled with
+// the SWAR ("SIMD Within A Register") version of ring_mul_tern_sparse, which
+// processes four coefficients with 64-bit integer instructions. It is intended
+// for 64-bit platforms without vector extensions (or compilers that do not
+// vectorize the C99 version) and is not used when AVRNTRU_USE_SIMD selects a
+// vectorized version or when the Assembler version is used on AVR.
+
+// #define AVRNTRU_USE_SWAR
+
+// The identifier AVRNTRU_USE_DISPATCH determines whether the implementation of
+// ring_mul_tern_sparse and ring_mul_tern_sparse2 (as well as of their "part"
+// and "wide" versions and of ring_mul_tern_sparse_multi) is selected at run-
+// time from a registry of kernels (see ring_dispatch.c) instead of at compile-
+// time. The selection is done once, at program start, according to the
+// features of the processor, but it can be overridden through the environment
+// variable AVRNTRU_KERNEL (e.g. AVRNTRU_KERNEL=sse2). On x86 platforms, the
+// vectorized kernels are then compiled with function-specific target options,
+// i.e. one binary contains the SSE2, AVX2, and AVX-512 versions and uses the
+// fastest version that the processor supports. AVRNTRU_USE_DISPATCH is
+// ignored on AVR and not defined by default (e.g. gcc with option
+// -DAVRNTRU_USE_DISPATCH).
+
+// #define AVRNTRU_USE_DISPATCH
+
+#if defined(AVRNTRU_USE_DISPATCH) && !defined(__AVR__)
+#define AVRNTRU_DISPATCH
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AVRNTRU_X86_TARGETS
+#endif
+#endif
+
+// The identifier AVRNTRU_MAX_BATCH specifies the maximum number of ring-
+// elements that are processed together by the multi-key multiplication
+// ring_mul_tern_prodform_multi. Larger batches are split up into groups of
+// AVRNTRU_MAX_BATCH ring-elements. Note that each ring-element of a group
+// requires a temporary array of N+7 elements on the stack, i.e. the stack
+// consumption of ring_mul_tern_prodform_multi grows linearly with
+// AVRNTRU_MAX_BATCH.
+
+#define AVRNTRU_MAX_BATCH 8
+
+// The identifier AVRNTRU_TILE_LEN specifies the number of coefficients of the
+// output tiles of the multi-key multiplication ring_mul_tern_sparse_multi and
+// must be a multiple of 16. For each tile, the indices of the sparse operand
+// are computed once (the "schedule") and then used for all ring-elements, so
+// that the accessed sections of a ring-element are loaded into the cache once
+// per tile (see ring_arith.c). A tile of AVRNTRU_TILE_LEN coefficients needs a
+// schedule of AVRNTRU_TILE_LEN/8 indices per non-0 coefficient on the stack.
+// The best value depends on the cache sizes of the processor, which is why it
+// can also be set on the command line (e.g. gcc with -DAVRNTRU_TILE_LEN=256);
+// a value of at least AVRNTRU_MAX_DIM + 7 disables the tiling.
+
+#ifndef AVRNTRU_TILE_LEN
+#define AVRNTRU_TILE_LEN 256
+#endif
+
+#if (AVRNTRU_TILE_LEN <= 0) || (AVRNTRU_TILE_LEN % 16 != 0)
+#error "AVRNTRU_TILE_LEN must be a positive multiple of 16"
+#endif
+
+// The identifier AVRNTRU_PUBKEY_PAD specifies the number of wrap-around
+// elements of a prepared public key (see ntru_pubkey_init), i.e. the key h(x)
+// is stored in an array of N+AVRNTRU_PUBKEY_PAD elements with h[N+i] = h[i].
+// Seven elements are sufficient for the AVR and C99 version, which process
+// eight coefficients at a time. The AVX2 version benefits from 15 elements
+// since they allow it to fetch 16 coefficients through a single 256-bit load
+// (instead of two 128-bit loads from u[idx] and u[idx+8 mod N]). The value is
+// derived from the target and AVRNTRU_USE_SIMD (or AVRNTRU_DISPATCH, since the
+// registry may select the AVX2 version at run-time) and should not be changed.
+
+#if (defined(__AVX2__) && defined(AVRNTRU_USE_SIMD)) || \
+    defined(AVRNTRU_X86_TARGETS)
+#define AVRNTRU_PUBKEY_PAD 15
+#else
+#define AVRNTRU_PUBKEY_PAD 7
+#endif
+
+// The identifier AVRNTRU_USE_THREADS determines whether the multi-threaded
+// product-form multiplication (see ring_mt.c) is compiled, which distributes
+// the coefficients of the result among a pool of POSIX threads to reduce the
+// latency of a single multiplication on multi-core processors. It is ignored
+// on AVR and not defined by default, i.e. it has to be set on the command line
+// (e.g. gcc with -DAVRNTRU_USE_THREADS -pthread). AVRNTRU_MAX_THREADS is the
+// maximum number of threads of a pool, including the calling thread.
+
+// #define AVRNTRU_USE_THREADS
+#define AVRNTRU_MAX_THREADS 8
+
+// The identifier AVRNTRU_USE_STATS determines whether the high-level functions
+// of the ring arithmetic and the NTRU operations are instrumented to count the
+// calls of the kernels and stages (e.g. zeroing and copying of the temporary
+// arrays of ring_mul_tern_prodform, or the final reduction), accumulate their
+// cycles, and record the stack high-water mark (see stats.c). It is not
+// defined by default, in which case the instrumentation is compiled out
+// completely; otherwise stats.c has to be compiled and linked as well (e.g.
+// gcc with -DAVRNTRU_USE_STATS). On AVR, the statistics use Timer1.
+
+// #define AVRNTRU_USE_STATS
+
 // xxx
 
 #ifndef NDEBUG
@@ -71,9 +215,10 @@
 #endif
 
 #define AVRNTRU_NO_ERROR           0
-#define AVRNTRU_ERR_xxx1           1
-#define AVRNTRU_ERR_xxx2           2
-#define AVRNTRU_ERR_xxx3           4
+#define AVRNTRU_ERR_MSGLEN         1
+#define AVRNTRU_ERR_DECODE         2
+#define AVRNTRU_ERR_THREAD         4
+#define AVRNTRU_ERR_INVERT         8
 
 // AVRNTRU comes with optimized Assembler implementations of many "low-level"
 // functions that are performance-critical and/or can potentially leak secret
@@ -85,16 +230,163 @@
 // call these low-level functions using a suffix-less version of the function
 // name, which works because the following preprocessor directives rename the
 // suffix-less function into either the Assembler function or the C function,
-// depending on whether AVRNTRU_USE_ASM is defined or not.
+// depending on whether AVRNTRU_USE_ASM is defined or not. On x86-64 platforms,
+// the suffix-less function is renamed into the vectorized version (which has a
+// "_avx2" or "_avx512" suffix) when AVRNTRU_USE_SIMD is defined.
+
+#if defined(__AVR__) && defined(AVRNTRU_USE_ASM) && (AVRNTRU_LOG_Q != 11)
+#error "The Assembler functions require AVRNTRU_LOG_Q = 11 (i.e. q = 2048)"
+#endif
 
 #if defined(__AVR__) && defined(AVRNTRU_USE_ASM)
 extern void ring_mul_tern_sparse_avr(uint16_t *z, const uint16_t *u, \
   uint16_t *v, int vlen, int N);
 #define ring_mul_tern_sparse(z, u, v, vlen, N) \
   ring_mul_tern_sparse_avr((z), (u), (v), (vlen), (N))
+#elif defined(AVRNTRU_DISPATCH)
+extern void (*ring_mul_tern_sparse_ptr)(uint16_t *z, const uint16_t *u, \
+  const uint16_t *v, int vlen, int N);
+#define ring_mul_tern_sparse(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_ptr((z), (u), (v), (vlen), (N))
+#elif defined(__AVX512BW__) && defined(AVRNTRU_USE_SIMD)
+#define ring_mul_tern_sparse(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_avx512((z), (u), (v), (vlen), (N))
+#elif defined(__AVX2__) && defined(AVRNTRU_USE_SIMD)
+#define ring_mul_tern_sparse(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_avx2((z), (u), (v), (vlen), (N))
+#elif defined(AVRNTRU_USE_SWAR)
+#define ring_mul_tern_sparse(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_swar((z), (u), (v), (vlen), (N))
+#elif defined(AVRNTRU_SPECIALIZE)
+#define ring_mul_tern_sparse(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_spec((z), (u), (v), (vlen), (N))
 #else   // the C versions of the functions are used
 #define ring_mul_tern_sparse(z, u, v, vlen, N) \
   ring_mul_tern_sparse_c99((z), (u), (v), (vlen), (N))
 #endif  // defined(__AVR__) && ...
 
+#if defined(__AVR__) && defined(AVRNTRU_USE_ASM)
+extern void ring_add_tern_avr(uint16_t *r, const uint16_t *m, int N);
+extern void ring_red_mod3_avr(uint16_t *r, const uint16_t *a, int N);
+extern void ring_mul_tern_sparse_mod3_avr(uint16_t *z, const uint16_t *u, \
+  const uint16_t *v, int vlen, int N);
+#define ring_add_tern(r, m, N) ring_add_tern_avr((r), (m), (N))
+#define ring_red_mod3(r, a, N) ring_red_mod3_avr((r), (a), (N))
+#define ring_mul_tern_sparse_mod3(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_mod3_avr((z), (u), (v), (vlen), (N))
+#else   // the C versions of the functions are used
+#define ring_add_tern(r, m, N) ring_add_tern_c99((r), (m), (N))
+#define ring_red_mod3(r, a, N) ring_red_mod3_c99((r), (a), (N))
+#define ring_mul_tern_sparse_mod3(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_mod3_c99((z), (u), (v), (vlen), (N))
+#endif  // defined(__AVR__) && ...
+
+#if defined(__AVR__) && defined(AVRNTRU_USE_ASM)
+extern void ring_mul_tern_sparse2_avr(uint16_t *z, const uint16_t *u, \
+  const uint16_t *w, const uint16_t *v, int vlen1, int vlen2, int N);
+#define ring_mul_tern_sparse2(z, u, w, v, vlen1, vlen2, N) \
+  ring_mul_tern_sparse2_avr((z), (u), (w), (v), (vlen1), (vlen2), (N))
+#elif defined(AVRNTRU_DISPATCH)
+extern void (*ring_mul_tern_sparse2_ptr)(uint16_t *z, const uint16_t *u, \
+  const uint16_t *w, const uint16_t *v, int vlen1, int vlen2, int N);
+#define ring_mul_tern_sparse2(z, u, w, v, vlen1, vlen2, N) \
+  ring_mul_tern_sparse2_ptr((z), (u), (w), (v), (vlen1), (vlen2), (N))
+#elif defined(__AVX2__) && defined(AVRNTRU_USE_SIMD)
+#define ring_mul_tern_sparse2(z, u, w, v, vlen1, vlen2, N) \
+  ring_mul_tern_sparse2_avx2((z), (u), (w), (v), (vlen1), (vlen2), (N))
+#elif defined(AVRNTRU_SPECIALIZE)
+#define ring_mul_tern_sparse2(z, u, w, v, vlen1, vlen2, N) \
+  ring_mul_tern_sparse2_spec((z), (u), (w), (v), (vlen1), (vlen2), (N))
+#else   // the C version of the function is used
+#define ring_mul_tern_sparse2(z, u, w, v, vlen1, vlen2, N) \
+  ring_mul_tern_sparse2_c99((z), (u), (w), (v), (vlen1), (vlen2), (N))
+#endif  // defined(__AVR__) && ...
+
+// The "part" version of ring_mul_tern_sparse2 computes a range of blocks of
+// eight coefficients (e.g. the share of a thread); it is not available on AVR.
+
+#if defined(AVRNTRU_DISPATCH)
+extern void (*ring_mul_tern_sparse2_part_ptr)(uint16_t *z, \
+  const uint16_t *u, const uint16_t *w, const uint16_t *v, int vlen1, \
+  int vlen2, int lo, int hi, int N);
+#define ring_mul_tern_sparse2_part(z, u, w, v, vlen1, vlen2, lo, hi, N) \
+  ring_mul_tern_sparse2_part_ptr((z), (u), (w), (v), (vlen1), (vlen2), \
+                                 (lo), (hi), (N))
+#elif defined(__AVX2__) && defined(AVRNTRU_USE_SIMD)
+#define ring_mul_tern_sparse2_part(z, u, w, v, vlen1, vlen2, lo, hi, N) \
+  ring_mul_tern_sparse2_part_avx2((z), (u), (w), (v), (vlen1), (vlen2), \
+                                  (lo), (hi), (N))
+#else   // the C version of the function is used
+#define ring_mul_tern_sparse2_part(z, u, w, v, vlen1, vlen2, lo, hi, N) \
+  ring_mul_tern_sparse2_part_c99((z), (u), (w), (v), (vlen1), (vlen2), \
+                                 (lo), (hi), (N))
+#endif  // defined(AVRNTRU_DISPATCH)
+
+// The "wide" versions of ring_mul_tern_sparse and ring_mul_tern_sparse2 expect
+// operands with AVRNTRU_PUBKEY_PAD wrap-around elements; they only differ from
+// the normal versions when the AVX2 version is used.
+
+#if defined(AVRNTRU_DISPATCH)
+extern void (*ring_mul_tern_sparse_wide_ptr)(uint16_t *z, const uint16_t *u, \
+  const uint16_t *v, int vlen, int N);
+extern void (*ring_mul_tern_sparse2_wide_ptr)(uint16_t *z, \
+  const uint16_t *u, const uint16_t *w, const uint16_t *v, int vlen1, \
+  int vlen2, int N);
+#define ring_mul_tern_sparse_wide(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_wide_ptr((z), (u), (v), (vlen), (N))
+#define ring_mul_tern_sparse2_wide(z, u, w, v, vlen1, vlen2, N) \
+  ring_mul_tern_sparse2_wide_ptr((z), (u), (w), (v), (vlen1), (vlen2), (N))
+#elif defined(__AVX2__) && defined(AVRNTRU_USE_SIMD)
+#define ring_mul_tern_sparse_wide(z, u, v, vlen, N) \
+  ring_mul_tern_sparse_wide_avx2((z), (u), (v), (vlen), (N))
+#define ring_mul_tern_sparse2_wide(z, u, w, v, vlen1, vlen2, N) \
+  ring_mul_tern_sparse2_wide_avx2((z), (u), (w), (v), (vlen1), (vlen2), (N))
+#else   // the normal versions of the functions are used
+#define ring_mul_tern_sparse_wide(z, u, v, vlen, N) \
+  ring_mul_tern_sparse((z), (u), (v), (vlen), (N))
+#define ring_mul_tern_sparse2_wide(z, u, w, v, vlen1, vlen2, N) \
+  ring_mul_tern_sparse2((z), (u), (w), (v), (vlen1), (vlen2), (N))
+#endif  // defined(AVRNTRU_DISPATCH)
+
+// ring_mul3_add has no Assembler version (yet), so the C version is used
+#define ring_mul3_add(r, e, N) ring_mul3_add_c99((r), (e), (N))
+
+// ring_red_modq has no Assembler version, so the C version is used
+#define ring_red_modq(r, a, q, N) ring_red_modq_c99((r), (a), (q), (N))
+
+#if defined(__AVR__) && defined(AVRNTRU_USE_ASM)
+extern void ring_unpack_avr(uint16_t *a, const uint8_t *in, int N);
+#define ring_unpack(a, in, N) ring_unpack_avr((a), (in), (N))
+#elif defined(__AVX2__) && defined(AVRNTRU_USE_SIMD)
+#define ring_unpack(a, in, N) ring_unpack_avx2((a), (in), (N))
+#else   // the C version of the function is used
+#define ring_unpack(a, in, N) ring_unpack_c99((a), (in), (N))
+#endif  // defined(__AVR__) && ...
+
+// ring_pack has no Assembler version, so the C version is used
+#define ring_pack(out, a, N) ring_pack_c99((out), (a), (N))
+
+// The multi-buffer SHA-256 compression of the index generation processes eight
+// blocks at once with AVX2 or one block after the other with the C version.
+// Like ring_unpack, it is not part of the kernel registry (ring_dispatch.c),
+// i.e. it is selected at compile time even when AVRNTRU_DISPATCH is defined.
+#if defined(__AVX2__) && defined(AVRNTRU_USE_SIMD)
+#define sha256_compress_x8(st, blk) sha256_compress_x8_avx2((st), (blk))
+#else   // the C version of the function is used
+#define sha256_compress_x8(st, blk) sha256_compress_x8_c99((st), (blk))
+#endif  // defined(__AVX2__) && ...
+
+#if defined(AVRNTRU_DISPATCH)
+extern void (*ring_mul_tern_sparse_multi_ptr)(uint16_t *z[], \
+  const uint16_t *u[], const uint16_t *start, int vlen, int num, int N);
+#define ring_mul_tern_sparse_multi(z, u, s, vlen, num, N) \
+  ring_mul_tern_sparse_multi_ptr((z), (u), (s), (vlen), (num), (N))
+#elif defined(__AVX2__) && defined(AVRNTRU_USE_SIMD)
+#define ring_mul_tern_sparse_multi(z, u, s, vlen, num, N) \
+  ring_mul_tern_sparse_multi_avx2((z), (u), (s), (vlen), (num), (N))
+#else   // the C version of the function is used
+#define ring_mul_tern_sparse_multi(z, u, s, vlen, num, N) \
+  ring_mul_tern_sparse_multi_c99((z), (u), (s), (vlen), (num), (N))
+#endif  // defined(AVRNTRU_DISPATCH)
+
 #endif  // AVRNTRU_CONFIG_H
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_bulk.c: Bulk Encryption and Decryption with a Work-Stealing Pool.    //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "config.h"
+#include "ntru_bulk.h"
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+
+
+// Every thread of the pool owns a range of job-numbers, which is represented
+// by a 64-bit word containing the first (head) and the end (tail) of the range
+// in the lower and upper 32 bits. The owner takes jobs from the head, while
+// other threads steal jobs from the tail. Both are done with a single atomic
+// compare-and-swap on the whole word, i.e. no lock is needed. The words are
+// padded to 64 bytes so that two threads never share a cache line.
+
+typedef struct bulk_queue {
+  uint64_t range;             // head and tail of the range of job-numbers
+  uint8_t pad[56];            // padding to the size of a cache line
+} bulk_queue_t;
+
+typedef struct bulk_ctx {
+  ntru_bulk_job_t *jobs;      // array of all jobs
+  bulk_queue_t queue[AVRNTRU_MAX_THREADS];
+} bulk_ctx_t;
+
+
+// The function <bulk_take> removes a job-number from the head (when <front>
+// is 1) or from the tail (when <front> is 0) of the range <q>. It returns -1
+// when the range is empty.
+
+static int bulk_take(bulk_queue_t *q, int front)
+{
+  uint64_t old, new;
+  uint32_t head, tail;
+
+  old = __atomic_load_n(&q->range, __ATOMIC_ACQUIRE);
+  do {
+    head = (uint32_t) old;
+    tail = (uint32_t) (old >> 32);
+    if (head >= tail) return -1;
+    if (front) head ++; else tail --;
+    new = (((uint64_t) tail) << 32) | head;
+  } while (!__atomic_compare_exchange_n(&q->range, &old, new, 1, \
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+  return (int) (front ? head - 1 : tail);
+}
+
+
+// The function <bulk_exec> executes a single job. The temporary arrays of
+// ntru_encrypt and ntru_decrypt (and of the ring arithmetic they call) are
+// allocated on the stack of the executing thread, which acts as per-thread
+// scratch memory; no job requires memory from the heap.
+
+static void bulk_exec(ntru_bulk_job_t *job)
+{
+  if (job->op == NTRU_BULK_ENCRYPT)
+    job->err = ntru_encrypt(job->e, job->msg, job->msglen, job->key, job->pk);
+  else
+    job->err = ntru_decrypt(job->msg, job->msglen, job->e, job->key, job->p);
+}
+
+
+// The job-function <bulk_main> is executed by every thread of the pool. The
+// thread first processes the jobs of its own range and then steals jobs from
+// the ranges of the other threads, starting with its right neighbour. Since
+// no jobs are added while the engine runs, a range that has become empty
+// remains empty, i.e. one pass over the other threads is sufficient.
+
+static void bulk_main(void *arg, int id, int num)
+{
+  bulk_ctx_t *ctx = (bulk_ctx_t *) arg;
+  bulk_queue_t *q;
+  int i, k;
+
+  while ((k = bulk_take(&ctx->queue[id], 1)) >= 0) bulk_exec(&ctx->jobs[k]);
+  for (i = 1; i < num; i ++) {
+    q = &ctx->queue[(id + i) % num];
+    while ((k = bulk_take(q, 0)) >= 0) bulk_exec(&ctx->jobs[k]);
+  }
+}
+
+
+// The function <ntru_bulk_run> executes the <num> jobs of array <jobs> on the
+// threads of the pool <pool> and returns when all of them are completed. The
+// jobs are initially distributed in contiguous ranges of (almost) equal size
+// among the threads; threads that finish their range early steal jobs from
+// the others, which balances different job-types and parameter sets as well
+// as threads that are delayed by the operating system. The jobs must be
+// independent, i.e. they must not write to the same arrays.
+
+void ntru_bulk_run(ring_pool_t *pool, ntru_bulk_job_t *jobs, int num)
+{
+  bulk_ctx_t ctx;
+  uint64_t head, tail;
+  int i, nt = pool->num_threads;
+
+  ctx.jobs = jobs;
+  for (i = 0; i < nt; i ++) {
+    head = (uint64_t) (((int64_t) i*num)/nt);
+    tail = (uint64_t) (((int64_t) (i + 1)*num)/nt);
+    ctx.queue[i].range = (tail << 32) | head;
+  }
+  ring_pool_run(pool, bulk_main, &ctx);
+}
+
+#endif  // defined(AVRNTRU_USE_THREADS) && ...
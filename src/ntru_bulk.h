@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_bulk.h: Bulk Encryption and Decryption with a Work-Stealing Pool.    //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_NTRU_BULK_H
+#define AVRNTRU_NTRU_BULK_H
+
+#include "typedefs.h"
+#include "config.h"
+#include "ntru_encrypt.h"
+#include "ring_mt.h"
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+
+#define NTRU_BULK_ENCRYPT 0
+#define NTRU_BULK_DECRYPT 1
+
+// Struct for a job of the bulk engine, which is either an encryption (the
+// message <msg> is encrypted under the prepared public key <pk> using <key> as
+// blinding polynomial r(x), and the ciphertext is written to <e>) or a
+// decryption (the ciphertext <e> is decrypted with <key> as private key F(x)
+// of the parameter set <p>, and the message is written to <msg>). The error
+// code returned by ntru_encrypt or ntru_decrypt is stored in <err>.
+
+typedef struct ntru_bulk_job {
+  int op;                     // NTRU_BULK_ENCRYPT or NTRU_BULK_DECRYPT
+  uint16_t *e;                // ciphertext e(x) consisting of N+7 elements
+  uint8_t *msg;               // message (input of encrypt, output of decrypt)
+  int msglen;                 // length of the message in bytes
+  const prod_form_poly_t *key;  // blinding poly r(x) or private key F(x)
+  const ntru_pubkey_ctx_t *pk;  // prepared public key (only for encryption)
+  const ntru_params_t *p;     // parameter set (only for decryption)
+  int err;                    // error code of the job (output)
+} ntru_bulk_job_t;
+
+// Function prototypes
+
+void ntru_bulk_run(ring_pool_t *pool, ntru_bulk_job_t *jobs, int num);
+
+#endif  // defined(AVRNTRU_USE_THREADS) && ...
+
+#endif  // AVRNTRU_NTRU_BULK_H
@@ -0,0 +1,285 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_encrypt.c: Encryption and Decryption Pipeline of NTRUEncrypt.        //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "config.h"
+#include "ring_arith.h"
+#include "ring_pack.h"
+#include "ring_inv.h"
+#include "stats.h"
+#include "ntru_encrypt.h"
+
+
+// The macro INTMASK(x) converts an integer x to an "all-1" mask when x = 1 and
+// to an "all-0" mask when x = 0.
+
+#define INTMASK(x) (~((x) - 1))
+
+
+// The following preprocessor directives define the length of the temporary
+// arrays <m> in ntru_encrypt, <a> in ntru_decrypt, and <finv>, <t> in
+// ntru_keygen, which become either Variable-Length Arrays (VLAs) or static
+// arrays (see config.h).
+
+#ifdef AVRNTRU_USE_VLA
+// Microsoft Visual C does not support VLAs
+#if !(defined(_MSC_VER) && !defined(__ICL))
+#define _tlen (N + 7)
+#else  // static arrays are used
+#define _tlen (AVRNTRU_MAX_DIM + 7)
+#endif
+#endif
+
+
+// Parameter sets EES401EP2, EES443EP1, and EES743EP1 of the EESS #1 standard.
+// The maximum message length follows from the encoding of three message bits
+// into two ternary coefficients, i.e. it is floor(3*floor(N/2)/8) bytes.
+
+const ntru_params_t ees401ep2 = { 401,  8,  8,  6, 133,  75 };
+const ntru_params_t ees443ep1 = { 443,  9,  8,  5, 148,  82 };
+const ntru_params_t ees743ep1 = { 743, 11, 11, 15, 247, 139 };
+
+
+// The function <ntru_encode_msg> converts a message consisting of <msglen>
+// bytes into a ternary polynomial m(x) of degree up to N-1, which is written
+// to the array <m> of length N. The message is interpreted as a string of bits
+// (starting with the least-significant bit of msg[0]), which is split up into
+// groups of three bits. Each 3-bit group with value v in [0, 7] is converted
+// into two ternary coefficients m_2i = v/3 and m_2i+1 = v mod 3, whereby the
+// value 2 is represented by -1 (i.e. 0xFFFF). The conversion is performed in
+// constant time since the message is secret. Coefficients of m(x) that are not
+// needed for the encoding are set to 0. When the message is too long to fit
+// into N coefficients, the function returns AVRNTRU_ERR_MSGLEN.
+
+int ntru_encode_msg(uint16_t *m, const uint8_t *msg, int msglen, int N)
+{
+  int i, k, bitpos;
+  uint16_t v, t0, t1;
+
+  if (2*((8*msglen + 2)/3) > N) return AVRNTRU_ERR_MSGLEN;
+
+  for (i = N-1; i >= 0; i--) m[i] = 0;
+  for (bitpos = k = 0; bitpos < 8*msglen; bitpos += 3, k += 2) {
+    // extract the 3-bit group starting at position <bitpos>
+    i = bitpos >> 3;
+    v = msg[i];
+    if (i + 1 < msglen) v |= ((uint16_t) msg[i+1]) << 8;
+    v = (v >> (bitpos & 7)) & 7;
+    // convert v into two ternary coefficients t0 = v/3 and t1 = v mod 3
+    t0 = (v*11) >> 5;
+    t1 = v - 3*t0;
+    m[k  ] = t0 - (INTMASK(t0 >> 1) & 3);
+    m[k+1] = t1 - (INTMASK(t1 >> 1) & 3);
+  }
+
+  return AVRNTRU_NO_ERROR;
+}
+
+
+// The function <ntru_decode_msg> is the inverse of <ntru_encode_msg>, i.e. it
+// converts the ternary polynomial m(x) given by the array <m> (coefficients 0,
+// 1, or -1) back into a message of <msglen> bytes. Each pair of coefficients
+// (t0, t1) yields the 3-bit group v = 3*t0 + t1, whereby -1 is interpreted as
+// 2. The pair (-1, -1) would give v = 8 and can not be the result of a valid
+// encoding; the same holds for non-0 coefficients beyond the encoded message.
+// In both cases, AVRNTRU_ERR_DECODE is returned (the message is nonetheless
+// written to <msg> since the check is performed in constant time).
+
+int ntru_decode_msg(uint8_t *msg, const uint16_t *m, int msglen, int N)
+{
+  int i, k, bitpos;
+  uint16_t v, t0, t1, err = 0;
+
+  for (i = 0; i < msglen; i ++) msg[i] = 0;
+  for (bitpos = k = 0; bitpos < 8*msglen; bitpos += 3, k += 2) {
+    // convert the coefficients 0, 1, -1 (i.e. 0xFFFF) to 0, 1, 2
+    t0 = m[k  ] & 3; t0 -= t0 >> 1;
+    t1 = m[k+1] & 3; t1 -= t1 >> 1;
+    v = 3*t0 + t1;
+    err |= v >> 3;
+    // insert the 3-bit group at position <bitpos>
+    v = (v & 7) << (bitpos & 7);
+    i = bitpos >> 3;
+    msg[i] |= (uint8_t) v;
+    if (i + 1 < msglen) msg[i+1] |= (uint8_t) (v >> 8);
+    // bits of the last group beyond the message must be 0
+    else err |= v >> 8;
+  }
+  // coefficients beyond the encoded message must be 0
+  for (; k < N; k ++) err |= m[k];
+
+  return err ? AVRNTRU_ERR_DECODE : AVRNTRU_NO_ERROR;
+}
+
+
+// The function <ntru_pubkey_init> prepares the public key h(x), given by the
+// array <h> of N coefficients, for the encryption with the parameter set <p>.
+// The coefficients are copied to the array <buf>, which must have a length of
+// NTRU_PUBKEY_LEN(N) elements, and followed by AVRNTRU_PUBKEY_PAD wrap-around
+// elements (i.e. buf[N+i] = h[i]) in the layout expected by the active version
+// of the sparse multiplication. This has to be done only once per public key;
+// the struct <pk> can then be used for any number of encryptions.
+
+void ntru_pubkey_init(ntru_pubkey_ctx_t *pk, uint16_t *buf,
+                      const uint16_t *h, const ntru_params_t *p)
+{
+  int i, N = p->N;
+
+  for (i = 0; i < N; i ++) buf[i] = h[i];
+  for (i = 0; i < AVRNTRU_PUBKEY_PAD; i ++) buf[N+i] = h[i];
+  pk->h = buf;
+  pk->p = p;
+}
+
+
+// The function <ntru_pubkey_unpack> is a variant of <ntru_pubkey_init> for a
+// public key that was packed with <ring_pack> (e.g. to store it in a database
+// or to send it over a radio link), i.e. the coefficients of h(x) are taken
+// from the byte-string <in> of RING_PACKED_LEN(N) bytes. They are unpacked
+// straight into the array <buf> of NTRU_PUBKEY_LEN(N) elements, whereby the
+// wrap-around elements beyond the seven written by <ring_unpack> are added.
+
+void ntru_pubkey_unpack(ntru_pubkey_ctx_t *pk, uint16_t *buf,
+                        const uint8_t *in, const ntru_params_t *p)
+{
+  int i, N = p->N;
+
+  ring_unpack(buf, in, N);
+  for (i = 7; i < AVRNTRU_PUBKEY_PAD; i ++) buf[N+i] = buf[i];
+  pk->h = buf;
+  pk->p = p;
+}
+
+
+// The function <ntru_encrypt> encrypts a message of <msglen> bytes using the
+// public key h(x) and the product-form blinding polynomial r(x), i.e. it first
+// encodes the message into a ternary polynomial m(x) and then computes the
+// ciphertext e(x) = r(x)*h(x) + m(x) mod q. The public key and the parameter
+// set are given by the struct <pk>, which must have been prepared with the
+// function <ntru_pubkey_init>. The ciphertext e(x) is written to array <e>,
+// which must consist of N+7 elements, whereby e[N+i] = e[i] for 0 <= i < 7 so
+// that it can be directly used as operand of the decryption. Note that this
+// function implements the "raw" NTRU encryption primitive; the SVES padding
+// scheme of EESS #1 (which involves a hash function to derive r(x) and a mask
+// for m(x)) is not part of AVRNTRU.
+
+int ntru_encrypt(uint16_t *e, const uint8_t *msg, int msglen,
+                 const prod_form_poly_t *r, const ntru_pubkey_ctx_t *pk)
+{
+  const ntru_params_t *p = pk->p;
+  int i, N = p->N, err;
+  uint16_t m[_tlen];
+  AVRNTRU_STATS_VAR(start);
+
+  if (msglen > p->maxmsglen) return AVRNTRU_ERR_MSGLEN;
+  AVRNTRU_STATS_START(start);
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_ENCRYPT, m);
+  // message encoding: conversion of the message into a ternary polynomial
+  err = ntru_encode_msg(m, msg, msglen, N);
+  if (err != AVRNTRU_NO_ERROR) return err;
+  // multiplication of public key and blinding polynomial: e(x) = r(x)*h(x)
+  ring_mul_tern_prodform_wide(e, pk->h, r, N);
+  // addition of the message: e(x) = e(x) + m(x) mod q
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_REDUCE, ring_add_tern(e, m, N));
+  // e(x) becomes operand of a multiplication in ntru_decrypt
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_COPY,
+    for (i = 0; i < 7; i ++) e[N+i] = e[i]);
+  AVRNTRU_STATS_STOP(AVRNTRU_STAT_ENCRYPT, start);
+
+  return AVRNTRU_NO_ERROR;
+}
+
+
+// The function <ntru_decrypt> decrypts a ciphertext e(x) using the private key
+// f(x) = 1 + 3*F(x), whereby F(x) is a product-form polynomial. The array <e>
+// must consist of N+7 elements, as produced by <ntru_encrypt>. The decryption
+// consists of the following steps: (i) computation of a(x) = e(x)*f(x) mod q
+// via a(x) = e(x) + 3*e(x)*F(x), (ii) centering of the coefficients of a(x)
+// into the interval [-q/2, q/2-1] and reduction modulo 3, which yields m(x),
+// and (iii) decoding of m(x) into a message of <msglen> bytes. Steps (i) and
+// (ii) are fused into the function <ring_mul_tern_prodform_mod3>. When m(x) is
+// not a valid encoding, AVRNTRU_ERR_DECODE is returned.
+
+int ntru_decrypt(uint8_t *msg, int msglen, const uint16_t *e,
+                 const prod_form_poly_t *F, const ntru_params_t *p)
+{
+  int N = p->N, err;
+  uint16_t a[_tlen];
+  AVRNTRU_STATS_VAR(start);
+
+  if (msglen > p->maxmsglen) return AVRNTRU_ERR_MSGLEN;
+  AVRNTRU_STATS_START(start);
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_DECRYPT, a);
+  // a(x) = e(x) + 3*e(x)*F(x) = e(x)*f(x) mod q, centered and reduced mod 3
+  // in a single pass (ring_mul_tern_prodform, ring_mul3_add, ring_red_mod3)
+  ring_mul_tern_prodform_mod3(a, e, F, N);
+  // message decoding: conversion of m(x) into the message
+  err = ntru_decode_msg(msg, a, msglen, N);
+  AVRNTRU_STATS_STOP(AVRNTRU_STAT_DECRYPT, start);
+
+  return err;
+}
+
+
+// The function <ntru_keygen> computes the public key h(x) = 3*g(x)*f^-1(x) mod
+// q that belongs to the private key f(x) = 1 + 3*F(x) with the product-form
+// polynomial F(x) given by the struct <F>. The ternary polynomial g(x) with dg
+// "+1" and dg "-1" coefficients is given by the array <g> of 2*dg indices (the
+// indices of the "+1" coefficients followed by the indices of the "-1" ones),
+// just like a sparse sub-polynomial of a product-form polynomial. The N
+// coefficients of h(x) are written to array <h>, which can then be prepared
+// for encryption with <ntru_pubkey_init>. The inverse f^-1(x) is obtained via
+// <ring_inv_prodform>; when f(x) is not invertible, AVRNTRU_ERR_INVERT is
+// returned and the caller has to choose a new F(x). Since g(x) has more non-0
+// coefficients than the sparse multiplication supports (AVRNTRU_MAX_NZC), the
+// product g(x)*f^-1(x) is accumulated in chunks of up to AVRNTRU_MAX_NZC/2
+// "+1" and as many "-1" coefficients. The random choice of F(x) and g(x) is up
+// to the caller, as is the case for r(x) in <ntru_encrypt>.
+
+int ntru_keygen(uint16_t *h, const prod_form_poly_t *F, const uint16_t *g,
+                const ntru_params_t *p)
+{
+  int i, j, k, N = p->N, dg = p->dg, err;
+  uint16_t finv[_tlen], t[_tlen], v[AVRNTRU_MAX_NZC];
+  AVRNTRU_STATS_VAR(start);
+
+  AVRNTRU_STATS_START(start);
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_KEYGEN, v);
+  // inversion of f(x) = 1 + 3*F(x) modulo q
+  err = ring_inv_prodform(finv, F, N);
+  // t(x) = g(x)*f^-1(x), computed in chunks of 2*k non-0 coefficients of g(x)
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_ZERO,
+    for (i = ((N+7)&(-8))-1; i >= 0; i--) t[i] = 0);
+  for (i = 0; i < dg; i += k) {
+    k = dg - i;
+    if (k > AVRNTRU_MAX_NZC/2) k = AVRNTRU_MAX_NZC/2;
+    for (j = 0; j < k; j ++) {
+      v[j] = g[i+j];         // "+1" coefficients
+      v[k+j] = g[dg+i+j];    // "-1" coefficients
+    }
+    AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE,
+      ring_mul_tern_sparse(t, finv, v, 2*k, N));
+  }
+  // h(x) = 3*t(x) mod q
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_REDUCE,
+    for (i = 0; i < N; i ++) h[i] = (3*t[i]) & AVRNTRU_Q_MASK);
+  AVRNTRU_STATS_STOP(AVRNTRU_STAT_KEYGEN, start);
+
+  return err;
+}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_encrypt.h: Encryption and Decryption Pipeline of NTRUEncrypt.        //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_NTRU_ENCRYPT_H
+#define AVRNTRU_NTRU_ENCRYPT_H
+
+#include "typedefs.h"
+#include "config.h"
+#include "ring_arith.h"
+
+// Struct for the parameters of a product-form parameter set of NTRUEncrypt as
+// specified in the EESS #1 standard (e.g. EES401EP2, EES443EP1, EES743EP1).
+// The product-form private key F(x) = F1(x)*F2(x) + F3(x) and the blinding
+// polynomial r(x) = r1(x)*r2(x) + r3(x) have the same number of non-0 coeffs,
+// namely 2*df1, 2*df2, and 2*df3 (half of them are "+1" and the other "-1").
+
+typedef struct ntru_params {
+  int N;          // dimension of the NTRU ring (q = 2048 for all sets)
+  int df1;        // number of "+1" (resp. "-1") coefficients of F1 and r1
+  int df2;        // number of "+1" (resp. "-1") coefficients of F2 and r2
+  int df3;        // number of "+1" (resp. "-1") coefficients of F3 and r3
+  int dg;         // number of "+1" (resp. "-1") coefficients of g
+  int maxmsglen;  // maximum length of a message in bytes
+} ntru_params_t;
+
+// Struct for a prepared public key. The public key h(x) is used as operand
+// of the product-form multiplication in every encryption, which requires the
+// coefficients to be followed by AVRNTRU_PUBKEY_PAD wrap-around elements (see
+// config.h). Instead of building such a padded copy for each encryption, the
+// caller prepares the key once with <ntru_pubkey_init> and passes the struct
+// to <ntru_encrypt>. The members should be considered private; the array to
+// which <h> points is provided by the caller and must have a length of (at
+// least) NTRU_PUBKEY_LEN(N) elements.
+
+typedef struct ntru_pubkey_ctx {
+  uint16_t *h;                // coefficients of h(x) plus wrap-around elements
+  const ntru_params_t *p;     // parameter set to which the public key belongs
+} ntru_pubkey_ctx_t;
+
+#define NTRU_PUBKEY_LEN(N) ((N) + AVRNTRU_PUBKEY_PAD)
+
+// Supported parameter sets
+
+extern const ntru_params_t ees401ep2;
+extern const ntru_params_t ees443ep1;
+extern const ntru_params_t ees743ep1;
+
+// Function prototypes
+
+int ntru_encode_msg(uint16_t *m, const uint8_t *msg, int msglen, int N);
+int ntru_decode_msg(uint8_t *msg, const uint16_t *m, int msglen, int N);
+void ntru_pubkey_init(ntru_pubkey_ctx_t *pk, uint16_t *buf,
+                      const uint16_t *h, const ntru_params_t *p);
+void ntru_pubkey_unpack(ntru_pubkey_ctx_t *pk, uint16_t *buf,
+                        const uint8_t *in, const ntru_params_t *p);
+int ntru_encrypt(uint16_t *e, const uint8_t *msg, int msglen,
+                 const prod_form_poly_t *r, const ntru_pubkey_ctx_t *pk);
+int ntru_decrypt(uint8_t *msg, int msglen, const uint16_t *e,
+                 const prod_form_poly_t *F, const ntru_params_t *p);
+int ntru_keygen(uint16_t *h, const prod_form_poly_t *F, const uint16_t *g,
+                const ntru_params_t *p);
+
+#endif  // AVRNTRU_NTRU_ENCRYPT_H
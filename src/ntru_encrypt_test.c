@@ -0,0 +1,459 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_encrypt_test.c: Test Program for NTRU Encryption and Decryption.     //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+#define _POSIX_C_SOURCE 200809L  // clock_gettime and sysconf
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "ring_arith.h"
+#include "ntru_encrypt.h"
+#include "ntru_encrypt_test.h"
+#include "ntru_bulk.h"
+#include "ring_pack.h"
+#include "ring_inv.h"
+#include "ntru_igf.h"
+#include "ntru_stream.h"
+#include "stats.h"
+#include "utils.h"
+
+
+#ifdef __AVR__
+static FILE mystdout = FDEV_SETUP_STREAM(uart_putch, NULL, _FDEV_SETUP_WRITE);
+#endif
+
+
+// Encryption and decryption of a message with a key pair for EES401EP2
+
+void test_ntru_401(void)
+{
+  int i, N = 401, err;
+  const char *text = "AVRNTRU: NTRUEncrypt for 8-bit AVR";
+  int msglen = (int) strlen(text);
+  uint16_t h[401] = { H401COEFFS };  // see ntru_encrypt_test.h
+  uint16_t f401[44] = { F401INDICES };  // see ntru_encrypt_test.h
+  uint16_t r401[44] = { R401INDICES };  // see ntru_encrypt_test.h
+  // When N = 401, F1(x) and F2(x) have 16 non-0 coefficients, while F3(x) has
+  // 12 non-0 coefficients; the same holds for r1(x), r2(x), and r3(x).
+  prod_form_poly_t F = { &(f401[0]), 16, 16, 12 };
+  prod_form_poly_t r = { &(r401[0]), 16, 16, 12 };
+  uint16_t e[408];  // the ciphertext e(x) consists of N+7 elements
+  uint16_t pkbuf[NTRU_PUBKEY_LEN(401)];
+  ntru_pubkey_ctx_t pk;
+  uint8_t msg[75];
+
+  // The public key is prepared once; the array <pkbuf> holds the coefficients
+  // of h(x) followed by the wrap-around elements needed by the multiplication.
+  ntru_pubkey_init(&pk, pkbuf, h, &ees401ep2);
+
+  err = ntru_encrypt(e, (const uint8_t *) text, msglen, &r, &pk);
+  printf("e = { ");
+  for (i = 0; i < N-1; i ++) printf("%03x, ", e[i]);
+  printf("%03x }\n", e[N-1]);
+  // Expected result: { 65d, 048, 412, 039, 315, ..., 723, 1c0, 3c9, 29e, 5bb }
+
+  err |= ntru_decrypt(msg, msglen, e, &F, &ees401ep2);
+  printf("m = ");
+  for (i = 0; i < msglen; i ++) printf("%c", msg[i]);
+  printf("\n");
+  // Expected result: AVRNTRU: NTRUEncrypt for 8-bit AVR
+  printf("ntru_encrypt/ntru_decrypt (N=%i): %s\n", N, \
+         (err || memcmp(msg, text, msglen)) ? "FAILED" : "OK");
+}
+
+
+// Encryption with a packed public key and decryption of a packed ciphertext
+// for EES401EP2, i.e. both are converted to byte-strings of 552 bytes (instead
+// of 802 bytes) and unpacked again before use.
+
+void test_ntru_packed(void)
+{
+  int N = 401, err;
+  const char *text = "AVRNTRU: NTRUEncrypt for 8-bit AVR";
+  int msglen = (int) strlen(text);
+  uint16_t h[401] = { H401COEFFS };  // see ntru_encrypt_test.h
+  uint16_t f401[44] = { F401INDICES };  // see ntru_encrypt_test.h
+  uint16_t r401[44] = { R401INDICES };  // see ntru_encrypt_test.h
+  prod_form_poly_t F = { &(f401[0]), 16, 16, 12 };
+  prod_form_poly_t r = { &(r401[0]), 16, 16, 12 };
+  uint16_t e[408], pkbuf[NTRU_PUBKEY_LEN(401)];
+  uint8_t hpacked[RING_PACKED_LEN(401)], epacked[RING_PACKED_LEN(401)];
+  ntru_pubkey_ctx_t pk;
+  uint8_t msg[75];
+
+  ring_pack(hpacked, h, N);
+  ntru_pubkey_unpack(&pk, pkbuf, hpacked, &ees401ep2);
+  err = ntru_encrypt(e, (const uint8_t *) text, msglen, &r, &pk);
+  ring_pack(epacked, e, N);
+  ring_unpack(e, epacked, N);
+  err |= ntru_decrypt(msg, msglen, e, &F, &ees401ep2);
+  printf("ntru_encrypt/ntru_decrypt (N=%i, packed): %s\n", N, \
+         (err || memcmp(msg, text, msglen)) ? "FAILED" : "OK");
+}
+
+
+// Key generation for EES401EP2 with the private key F401INDICES and a g(x)
+// whose "+1" coefficients are at x^(3i) and "-1" coefficients at x^(3i+1),
+// followed by an encryption and decryption with the generated key pair. In
+// addition, f(x)*f^-1(x) = 1 mod q is checked, and the inversion modulo 2 of
+// the non-invertible polynomial 1 + x must fail.
+
+void test_ntru_keygen(void)
+{
+  int i, N = 401, err;
+  const char *text = "AVRNTRU: NTRUEncrypt for 8-bit AVR";
+  int msglen = (int) strlen(text);
+  uint16_t f401[44] = { F401INDICES };  // see ntru_encrypt_test.h
+  uint16_t r401[44] = { R401INDICES };  // see ntru_encrypt_test.h
+  prod_form_poly_t F = { &(f401[0]), 16, 16, 12 };
+  prod_form_poly_t r = { &(r401[0]), 16, 16, 12 };
+  uint16_t g[2*133], h[401], finv[408], t[408], e[408];
+  uint16_t pkbuf[NTRU_PUBKEY_LEN(401)];
+  ntru_pubkey_ctx_t pk;
+  uint8_t msg[75];
+
+  for (i = 0; i < 133; i ++) { g[i] = 3*i; g[133+i] = 3*i + 1; }
+  err = ntru_keygen(h, &F, g, &ees401ep2);
+  // f(x)*f^-1(x) = f^-1(x) + 3*F(x)*f^-1(x) must be 1
+  err |= ring_inv_prodform(finv, &F, N);
+  ring_mul_tern_prodform(t, finv, &F, N);
+  for (i = 0; i < N; i ++)
+    err |= ((finv[i] + 3*t[i] - (i == 0)) & AVRNTRU_Q_MASK) != 0;
+  // 1 + x is not invertible modulo 2 since it has a root at x = 1
+  for (i = 0; i < N; i ++) t[i] = (i < 2);
+  err |= (ring_inv_mod2(t, t, N) != AVRNTRU_ERR_INVERT);
+
+  ntru_pubkey_init(&pk, pkbuf, h, &ees401ep2);
+  err |= ntru_encrypt(e, (const uint8_t *) text, msglen, &r, &pk);
+  err |= ntru_decrypt(msg, msglen, e, &F, &ees401ep2);
+  printf("ntru_keygen (N=%i): %s\n", N, \
+         (err || memcmp(msg, text, msglen)) ? "FAILED" : "OK");
+}
+
+
+// Index generation: SHA-256 of "abc" (FIPS 180-4 example) with the single and
+// the multi-buffer compression, indices of the blinding polynomial for seed
+// "AVRNTRU" and EES401EP2 (computed with a Python model of ntru_gen_indices),
+// consistency of ntru_gen_indices_multi with ntru_gen_indices for 8 and 5
+// seeds of 70 bytes and EES743EP1, and an encryption/decryption with r(x)
+// derived from the seed.
+
+void test_ntru_igf(void)
+{
+  int i, k, err = 0;
+  const char *text = "AVRNTRU: NTRUEncrypt for 8-bit AVR";
+  int msglen = (int) strlen(text);
+  const uint32_t iv[8] = { 0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, \
+    0xA54FF53AUL, 0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL };
+  const uint32_t md[8] = { 0xBA7816BFUL, 0x8F01CFEAUL, 0x414140DEUL, \
+    0x5DAE2223UL, 0xB00361A3UL, 0x96177A9CUL, 0xB410FF61UL, 0xF20015ADUL };
+  const uint16_t r401ref[44] = { 57, 49, 283, 354, 329, 144, 108, 20, 39, \
+    163, 104, 22, 66, 175, 7, 74, 316, 93, 164, 175, 49, 333, 304, 360, 379, \
+    315, 319, 43, 76, 104, 191, 378, 244, 157, 130, 191, 71, 103, 289, 334, \
+    316, 6, 209, 57 };
+  uint16_t h[401] = { H401COEFFS };  // see ntru_encrypt_test.h
+  uint16_t f401[44] = { F401INDICES };  // see ntru_encrypt_test.h
+  uint16_t r401[44], idx[8][74], ref[74], *pidx[8];
+  prod_form_poly_t F = { &(f401[0]), 16, 16, 12 };
+  prod_form_poly_t r = { &(r401[0]), 16, 16, 12 };
+  uint32_t st[8], st8[64];
+  uint8_t block[64], seeds[8][70], msg[75];
+  const uint8_t *blk[8], *pseed[8];
+  uint16_t e[408], pkbuf[NTRU_PUBKEY_LEN(401)];
+  ntru_pubkey_ctx_t pk;
+
+  // SHA-256("abc"): one block with the message, 0x80, and the length 24
+  for (i = 0; i < 64; i ++) block[i] = 0;
+  block[0] = 'a'; block[1] = 'b'; block[2] = 'c'; block[3] = 0x80;
+  block[63] = 24;
+  for (i = 0; i < 8; i ++) st[i] = iv[i];
+  sha256_compress_c99(st, block);
+  for (i = 0; i < 64; i ++) st8[i] = iv[i/8];
+  for (i = 0; i < 8; i ++) blk[i] = block;
+  sha256_compress_x8(st8, blk);
+  for (i = 0; i < 64; i ++) err |= (st8[i] != md[i/8]) | (st[i/8] != md[i/8]);
+
+  ntru_gen_indices(r401, (const uint8_t *) "AVRNTRU", 7, &ees401ep2);
+  for (i = 0; i < 44; i ++) err |= (r401[i] != r401ref[i]);
+
+  for (k = 0; k < 8; k ++) {
+    for (i = 0; i < 70; i ++) seeds[k][i] = (uint8_t) (8*i + k);
+    pseed[k] = seeds[k];
+    pidx[k] = idx[k];
+  }
+  ntru_gen_indices_multi(pidx, pseed, 70, 8, &ees743ep1);
+  for (k = 0; k < 8; k ++) {
+    ntru_gen_indices(ref, seeds[k], 70, &ees743ep1);
+    for (i = 0; i < 74; i ++) err |= (idx[k][i] != ref[i]);
+  }
+  ntru_gen_indices_multi(pidx, pseed, 64, 5, &ees743ep1);
+  for (k = 0; k < 5; k ++) {
+    ntru_gen_indices(ref, seeds[k], 64, &ees743ep1);
+    for (i = 0; i < 74; i ++) err |= (idx[k][i] != ref[i]);
+  }
+
+  ntru_pubkey_init(&pk, pkbuf, h, &ees401ep2);
+  err |= ntru_encrypt(e, (const uint8_t *) text, msglen, &r, &pk);
+  err |= ntru_decrypt(msg, msglen, e, &F, &ees401ep2);
+  printf("ntru_gen_indices (N=401/743): %s\n", \
+         (err || memcmp(msg, text, msglen)) ? "FAILED" : "OK");
+}
+
+
+#ifndef __AVR__
+
+#define STREAM_LEN 1000  // 13 full blocks of 75 bytes and one of 25 bytes
+#define STREAM_CTLEN (14*RING_PACKED_LEN(401))
+
+// Streaming encryption of a payload of STREAM_LEN bytes (EES401EP2) in two
+// sections of 750 and 250 bytes, whereby the ciphertext of the last block is
+// compared with a "manual" encryption of the block (index generation from the
+// seed and the block number, ntru_encrypt, ring_pack). The ciphertexts are
+// decrypted in a single section. When AVRNTRU_USE_THREADS is defined, both
+// are repeated with a pool of three threads, which must yield the same result.
+
+void test_ntru_stream(void)
+{
+  int i, N = 401, err = 0;
+  uint16_t h[401] = { H401COEFFS };  // see ntru_encrypt_test.h
+  uint16_t f401[44] = { F401INDICES };  // see ntru_encrypt_test.h
+  prod_form_poly_t F = { &(f401[0]), 16, 16, 12 };
+  uint16_t pkbuf[NTRU_PUBKEY_LEN(401)], arena[NTRU_STREAM_ARENA_LEN(401)];
+  uint16_t ridx[44], e[408];
+  prod_form_poly_t r = { &(ridx[0]), 16, 16, 12 };
+  static uint8_t pt[STREAM_LEN], ct[STREAM_CTLEN], out[STREAM_LEN];
+  uint8_t seed[15] = { 's', 't', 'r', 'e', 'a', 'm', ' ', 's', 'e', 'e', \
+                       'd', 0, 0, 0, 13 }, ref[RING_PACKED_LEN(401)];
+  ntru_stream_ctx_t ctx;
+  ntru_pubkey_ctx_t pk;
+#if defined(AVRNTRU_USE_THREADS)
+  static uint8_t ct2[STREAM_CTLEN];
+  uint16_t arena2[NTRU_STREAM_ARENA_LEN(401)];
+  ring_pool_t pool;
+#endif
+
+  for (i = 0; i < STREAM_LEN; i ++) pt[i] = (uint8_t) (7*i + 1);
+  ntru_pubkey_init(&pk, pkbuf, h, &ees401ep2);
+
+  err |= ntru_stream_init_enc(&ctx, arena, &pk, seed, 11);
+  err |= ntru_stream_encrypt(&ctx, ct, pt, 750);
+  err |= ntru_stream_encrypt(&ctx, &ct[10*RING_PACKED_LEN(N)], &pt[750], 250);
+  // no section can follow a section with a shorter last block
+  err |= (ntru_stream_encrypt(&ctx, ref, pt, 75) != AVRNTRU_ERR_MSGLEN);
+  // block 13 encrypted with the blinding polynomial of seed || 0x0000000D
+  ntru_gen_indices(ridx, seed, 15, &ees401ep2);
+  err |= ntru_encrypt(e, &pt[975], 25, &r, &pk);
+  ring_pack(ref, e, N);
+  err |= memcmp(ref, &ct[13*RING_PACKED_LEN(N)], RING_PACKED_LEN(N));
+
+  ntru_stream_init_dec(&ctx, arena, &F, &ees401ep2);
+  err |= ntru_stream_decrypt(&ctx, out, ct, STREAM_LEN);
+  err |= memcmp(out, pt, STREAM_LEN);
+
+#if defined(AVRNTRU_USE_THREADS)
+  err |= ring_pool_init(&pool, 3);
+  ntru_stream_init_enc(&ctx, arena2, &pk, seed, 11);
+  ntru_stream_set_pool(&ctx, &pool);
+  err |= ntru_stream_encrypt(&ctx, ct2, pt, STREAM_LEN);
+  err |= memcmp(ct2, ct, STREAM_CTLEN);
+  ntru_stream_init_dec(&ctx, arena2, &F, &ees401ep2);
+  ntru_stream_set_pool(&ctx, &pool);
+  for (i = 0; i < STREAM_LEN; i ++) out[i] = 0;
+  err |= ntru_stream_decrypt(&ctx, out, ct2, STREAM_LEN);
+  err |= memcmp(out, pt, STREAM_LEN);
+  ring_pool_free(&pool);
+#endif
+  printf("ntru_stream (N=%i, len=%i): %s\n", N, STREAM_LEN, \
+         err ? "FAILED" : "OK");
+}
+
+#endif  // __AVR__
+
+
+#if defined(AVRNTRU_USE_STATS)
+
+// Encryption and decryption for EES401EP2 with the instrumentation enabled,
+// whereby the number of calls of the kernels and stages is checked and the
+// statistics are printed via avrntru_stats_dump.
+
+void test_ntru_stats(void)
+{
+  int N = 401, err;
+  const char *text = "AVRNTRU: NTRUEncrypt for 8-bit AVR";
+  int msglen = (int) strlen(text);
+  uint16_t h[401] = { H401COEFFS };  // see ntru_encrypt_test.h
+  uint16_t f401[44] = { F401INDICES };  // see ntru_encrypt_test.h
+  uint16_t r401[44] = { R401INDICES };  // see ntru_encrypt_test.h
+  prod_form_poly_t F = { &(f401[0]), 16, 16, 12 };
+  prod_form_poly_t r = { &(r401[0]), 16, 16, 12 };
+  uint16_t e[408], pkbuf[NTRU_PUBKEY_LEN(401)];
+  ntru_pubkey_ctx_t pk;
+  uint8_t msg[75];
+
+  ntru_pubkey_init(&pk, pkbuf, h, &ees401ep2);
+  avrntru_stats_reset();
+  err = ntru_encrypt(e, (const uint8_t *) text, msglen, &r, &pk);
+  err |= ntru_decrypt(msg, msglen, e, &F, &ees401ep2);
+  avrntru_stats_dump();
+  // encryption: one sparse multiplication and one sum of two products, plus
+  // one copy of the wrap-around elements of <t> and one of those of <e>;
+  // decryption: two sparse multiplications, one fused with the reduction mod 3
+  err |= (avrntru_stats[AVRNTRU_STAT_SPARSE].calls != 3);
+  err |= (avrntru_stats[AVRNTRU_STAT_SPARSE2].calls != 1);
+  err |= (avrntru_stats[AVRNTRU_STAT_SPARSE_MOD3].calls != 1);
+  err |= (avrntru_stats[AVRNTRU_STAT_ZERO].calls != 2);
+  err |= (avrntru_stats[AVRNTRU_STAT_COPY].calls != 3);
+  err |= (avrntru_stats[AVRNTRU_STAT_REDUCE].calls != 1);
+  err |= (avrntru_stats[AVRNTRU_STAT_PRODFORM].calls != 2);
+  err |= (avrntru_stats[AVRNTRU_STAT_ENCRYPT].calls != 1);
+  err |= (avrntru_stats[AVRNTRU_STAT_DECRYPT].calls != 1);
+  err |= (avrntru_stats[AVRNTRU_STAT_PRODFORM].cycles == 0);
+  err |= (avrntru_stats[AVRNTRU_STAT_PRODFORM].stack < (uint32_t) (2*N));
+  printf("avrntru_stats (N=%i): %s\n", N, \
+         (err || memcmp(msg, text, msglen)) ? "FAILED" : "OK");
+}
+
+#endif  // defined(AVRNTRU_USE_STATS)
+
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+
+#define BULK_JOBS 64
+
+// Encryption of BULK_JOBS different messages (EES401EP2) with ntru_bulk_run,
+// followed by the bulk decryption of the ciphertexts, whereby the results are
+// compared with those of ntru_encrypt and the original messages.
+
+void test_ntru_bulk(void)
+{
+  int i, k, N = 401, err = 0;
+  uint16_t h[401] = { H401COEFFS };  // see ntru_encrypt_test.h
+  uint16_t f401[44] = { F401INDICES };  // see ntru_encrypt_test.h
+  uint16_t r401[44] = { R401INDICES };  // see ntru_encrypt_test.h
+  prod_form_poly_t F = { &(f401[0]), 16, 16, 12 };
+  prod_form_poly_t r = { &(r401[0]), 16, 16, 12 };
+  uint16_t pkbuf[NTRU_PUBKEY_LEN(401)], e1[408], e2[BULK_JOBS][408];
+  uint8_t msg[BULK_JOBS][32], out[BULK_JOBS][32];
+  ntru_bulk_job_t jobs[BULK_JOBS];
+  ntru_pubkey_ctx_t pk;
+  ring_pool_t pool;
+
+  ntru_pubkey_init(&pk, pkbuf, h, &ees401ep2);
+  if (ring_pool_init(&pool, AVRNTRU_MAX_THREADS) != AVRNTRU_NO_ERROR) {
+    printf("ntru_bulk_run (N=%i, jobs=%i): FAILED\n", N, BULK_JOBS);
+    return;
+  }
+  for (k = 0; k < BULK_JOBS; k ++) {
+    for (i = 0; i < 32; i ++) msg[k][i] = (uint8_t) (k*32 + i);
+    jobs[k].op = NTRU_BULK_ENCRYPT; jobs[k].e = e2[k]; jobs[k].msg = msg[k];
+    jobs[k].msglen = 32; jobs[k].key = &r; jobs[k].pk = &pk; jobs[k].p = NULL;
+  }
+  ntru_bulk_run(&pool, jobs, BULK_JOBS);
+  for (k = 0; k < BULK_JOBS; k ++) {
+    err |= jobs[k].err | ntru_encrypt(e1, msg[k], 32, &r, &pk);
+    for (i = 0; i < N+7; i ++) err |= (e1[i] != e2[k][i]);
+    jobs[k].op = NTRU_BULK_DECRYPT; jobs[k].msg = out[k];
+    jobs[k].key = &F; jobs[k].p = &ees401ep2;
+  }
+  ntru_bulk_run(&pool, jobs, BULK_JOBS);
+  for (k = 0; k < BULK_JOBS; k ++)
+    err |= jobs[k].err | memcmp(msg[k], out[k], 32);
+  ring_pool_free(&pool);
+  printf("ntru_bulk_run (N=%i, jobs=%i): %s\n", N, BULK_JOBS, \
+         err ? "FAILED" : "OK");
+}
+
+
+// Throughput of ntru_bulk_run for a mix of encryptions and decryptions (half
+// each, EES401EP2) with pools of 1 thread up to the number of online cores,
+// but at most AVRNTRU_MAX_THREADS threads. The throughput is given in jobs per
+// second and measured over several rounds after a warm-up round.
+
+void bench_ntru_bulk(void)
+{
+  int i, k, n, ncores, rounds = 20;
+  uint16_t h[401] = { H401COEFFS };  // see ntru_encrypt_test.h
+  uint16_t f401[44] = { F401INDICES };  // see ntru_encrypt_test.h
+  uint16_t r401[44] = { R401INDICES };  // see ntru_encrypt_test.h
+  prod_form_poly_t F = { &(f401[0]), 16, 16, 12 };
+  prod_form_poly_t r = { &(r401[0]), 16, 16, 12 };
+  uint16_t pkbuf[NTRU_PUBKEY_LEN(401)], e[4*BULK_JOBS][408];
+  uint8_t msg[4*BULK_JOBS][32];
+  ntru_bulk_job_t jobs[4*BULK_JOBS];
+  ntru_pubkey_ctx_t pk;
+  ring_pool_t pool;
+  struct timespec t0, t1;
+  double sec;
+
+  ntru_pubkey_init(&pk, pkbuf, h, &ees401ep2);
+  for (k = 0; k < 4*BULK_JOBS; k ++) {
+    for (i = 0; i < 32; i ++) msg[k][i] = (uint8_t) (k + i);
+    ntru_encrypt(e[k], msg[k], 32, &r, &pk);
+    jobs[k].op = (k & 1) ? NTRU_BULK_DECRYPT : NTRU_BULK_ENCRYPT;
+    jobs[k].e = e[k]; jobs[k].msg = msg[k]; jobs[k].msglen = 32;
+    jobs[k].key = (k & 1) ? &F : &r; jobs[k].pk = &pk; jobs[k].p = &ees401ep2;
+  }
+  ncores = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncores < 1) ncores = 1;
+  if (ncores > AVRNTRU_MAX_THREADS) ncores = AVRNTRU_MAX_THREADS;
+  for (n = 1; n <= ncores; n ++) {
+    if (ring_pool_init(&pool, n) != AVRNTRU_NO_ERROR) break;
+    ntru_bulk_run(&pool, jobs, 4*BULK_JOBS);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < rounds; i ++) ntru_bulk_run(&pool, jobs, 4*BULK_JOBS);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ring_pool_free(&pool);
+    sec = (t1.tv_sec - t0.tv_sec) + 1e-9*(t1.tv_nsec - t0.tv_nsec);
+    printf("ntru_bulk_run (threads=%i): %.0f jobs/s\n", n, \
+           rounds*4*BULK_JOBS/sec);
+  }
+}
+
+#endif  // defined(AVRNTRU_USE_THREADS) && ...
+
+
+int main(void)
+{
+#ifdef __AVR__
+  init_uart();
+  stdout = &mystdout;
+#endif
+  
+  test_ntru_401();
+  test_ntru_packed();
+  test_ntru_keygen();
+  test_ntru_igf();
+#ifndef __AVR__
+  test_ntru_stream();
+#endif
+#if defined(AVRNTRU_USE_STATS)
+  test_ntru_stats();
+#endif
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+  test_ntru_bulk();
+  bench_ntru_bulk();
+#endif
+  
+  return 0;
+}
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_encrypt_test.h: Test Vectors for the NTRU Encryption/Decryption.     //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_NTRU_ENCRYPT_TEST_H
+#define AVRNTRU_NTRU_ENCRYPT_TEST_H
+
+// Public key h(x) = 3*g(x)*f^-1(x) mod 2048 for EES401EP2, where f(x) is given
+// by f(x) = 1 + 3*F(x) and F(x) is the product-form polynomial F401INDICES.
+
+#define H401COEFFS \
+0x1A7, 0x6D3, 0x3F9, 0x477, 0x714, 0x3C1, 0x1A8, 0x03E, 0x5DA, 0x619, \
+0x5E8, 0x74E, 0x694, 0x0AA, 0x786, 0x508, 0x5BC, 0x3BF, 0x70B, 0x545, \
+0x51C, 0x4F0, 0x6F2, 0x16D, 0x700, 0x047, 0x1B5, 0x3DF, 0x783, 0x339, \
+0x4D6, 0x409, 0x2B8, 0x50E, 0x3FE, 0x6B8, 0x404, 0x1E1, 0x6F1, 0x00A, \
+0x7B5, 0x3E4, 0x2EA, 0x63F, 0x00F, 0x6A5, 0x6FA, 0x4BD, 0x7A4, 0x718, \
+0x294, 0x401, 0x0AD, 0x739, 0x7BB, 0x6EB, 0x448, 0x485, 0x2B3, 0x02F, \
+0x0AA, 0x71F, 0x766, 0x58F, 0x4BB, 0x08B, 0x74E, 0x0A1, 0x53A, 0x279, \
+0x326, 0x7A8, 0x569, 0x01D, 0x3DA, 0x210, 0x512, 0x2C2, 0x526, 0x21F, \
+0x38A, 0x60D, 0x22E, 0x0E2, 0x322, 0x5AF, 0x0E8, 0x7C6, 0x7CB, 0x589, \
+0x7F5, 0x4C2, 0x4D9, 0x7F2, 0x5AC, 0x3E1, 0x420, 0x75D, 0x53A, 0x6E3, \
+0x431, 0x2B3, 0x58D, 0x64D, 0x77B, 0x326, 0x65A, 0x006, 0x57F, 0x4B1, \
+0x549, 0x5F4, 0x591, 0x31D, 0x33F, 0x6DB, 0x024, 0x712, 0x63C, 0x76C, \
+0x06B, 0x024, 0x0C2, 0x664, 0x7F4, 0x549, 0x5E9, 0x21B, 0x132, 0x7B4, \
+0x05D, 0x281, 0x2AD, 0x6E8, 0x759, 0x797, 0x51C, 0x162, 0x7D4, 0x1DC, \
+0x27F, 0x3B1, 0x0F3, 0x64F, 0x5DC, 0x1BA, 0x63C, 0x09C, 0x0C3, 0x0A4, \
+0x536, 0x08E, 0x6C7, 0x11F, 0x2A4, 0x77B, 0x6B2, 0x688, 0x199, 0x0D1, \
+0x517, 0x4B1, 0x723, 0x7FA, 0x371, 0x4D6, 0x473, 0x36F, 0x29A, 0x680, \
+0x446, 0x156, 0x0A1, 0x0D6, 0x0D4, 0x689, 0x7E5, 0x699, 0x12C, 0x5AD, \
+0x4F8, 0x067, 0x31B, 0x518, 0x3A9, 0x7F6, 0x16E, 0x2D4, 0x739, 0x739, \
+0x44C, 0x0C7, 0x194, 0x0B7, 0x5AE, 0x0EB, 0x631, 0x49C, 0x02C, 0x6C4, \
+0x436, 0x395, 0x2CB, 0x7A0, 0x51D, 0x7BD, 0x0F0, 0x4B3, 0x22B, 0x0EF, \
+0x197, 0x2C4, 0x44D, 0x6BE, 0x384, 0x1AF, 0x10D, 0x4D2, 0x19B, 0x1FA, \
+0x2BA, 0x5AE, 0x121, 0x1CA, 0x02E, 0x5DD, 0x65E, 0x248, 0x642, 0x4D1, \
+0x4FE, 0x3EA, 0x3B0, 0x505, 0x045, 0x236, 0x0FD, 0x452, 0x705, 0x554, \
+0x2D2, 0x081, 0x642, 0x626, 0x6B7, 0x74B, 0x3D5, 0x13F, 0x14B, 0x432, \
+0x1F0, 0x72A, 0x099, 0x2DC, 0x705, 0x23B, 0x4AF, 0x194, 0x43B, 0x1A7, \
+0x0A0, 0x2AA, 0x5CD, 0x02C, 0x476, 0x3AD, 0x560, 0x355, 0x723, 0x5D6, \
+0x6A8, 0x14D, 0x77C, 0x0BF, 0x3B9, 0x74F, 0x393, 0x718, 0x3EE, 0x20C, \
+0x096, 0x105, 0x061, 0x088, 0x58F, 0x7BD, 0x744, 0x7B0, 0x7CB, 0x687, \
+0x1E2, 0x48D, 0x44A, 0x00B, 0x155, 0x4D1, 0x2F3, 0x78B, 0x48C, 0x404, \
+0x027, 0x76C, 0x35D, 0x433, 0x330, 0x232, 0x570, 0x0AA, 0x7F7, 0x320, \
+0x30F, 0x476, 0x693, 0x354, 0x3AD, 0x3F6, 0x6C6, 0x17A, 0x2EA, 0x639, \
+0x1CA, 0x4F4, 0x6AE, 0x6FF, 0x785, 0x44E, 0x2E0, 0x5FF, 0x562, 0x5E2, \
+0x6BA, 0x24D, 0x081, 0x745, 0x1A3, 0x5E9, 0x3C3, 0x0A7, 0x32E, 0x621, \
+0x5DE, 0x41C, 0x43E, 0x320, 0x3B9, 0x77C, 0x1F8, 0x520, 0x5DB, 0x61F, \
+0x122, 0x11B, 0x78C, 0x0C8, 0x3B5, 0x425, 0x0EB, 0x2E1, 0x037, 0x040, \
+0x67B, 0x764, 0x4C8, 0x16A, 0x686, 0x629, 0x56E, 0x4D9, 0x38F, 0x246, \
+0x167, 0x16A, 0x0E9, 0x4F2, 0x5F4, 0x3AD, 0x713, 0x71E, 0x42C, 0x513, \
+0x23C, 0x154, 0x411, 0x6EE, 0x457, 0x1B9, 0x16B, 0x0AE, 0x1A0, 0x5C5, \
+0x71C, 0x389, 0x270, 0x1F4, 0x065, 0x7C6, 0x2CF, 0x044, 0x5E6, 0x7FC, \
+0x051
+
+// Indices of the non-0 coefficients of the private key F(x) = F1*F2 + F3
+
+#define F401INDICES \
+0x046, 0x0EC, 0x13C, 0x107, 0x15E, 0x085, 0x0D4, 0x14B, \
+0x00C, 0x010, 0x0D9, 0x07E, 0x0A4, 0x053, 0x104, 0x0CF, \
+0x14D, 0x128, 0x06A, 0x0DF, 0x131, 0x023, 0x15C, 0x0BF, \
+0x16F, 0x159, 0x05B, 0x16D, 0x177, 0x0E9, 0x06E, 0x0D6, \
+0x095, 0x13A, 0x108, 0x17C, 0x0E0, 0x077, 0x06B, 0x152, \
+0x175, 0x139, 0x014, 0x0A2
+
+// Indices of the non-0 coefficients of the blinding polynomial r = r1*r2 + r3
+
+#define R401INDICES \
+0x0DC, 0x092, 0x0C3, 0x173, 0x11F, 0x10F, 0x06D, 0x18E, \
+0x158, 0x0D9, 0x015, 0x140, 0x0B5, 0x0EB, 0x01F, 0x157, \
+0x123, 0x11A, 0x032, 0x13B, 0x180, 0x058, 0x017, 0x15B, \
+0x175, 0x104, 0x132, 0x0E6, 0x0B9, 0x17C, 0x08B, 0x139, \
+0x0EC, 0x12D, 0x165, 0x187, 0x056, 0x021, 0x134, 0x059, \
+0x0FB, 0x094, 0x0F1, 0x152
+
+#endif  // AVRNTRU_NTRU_ENCRYPT_TEST_H
@@ -0,0 +1,370 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_igf.c: Index Generation for Product-Form Polynomials.                //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "config.h"
+#include "ntru_encrypt.h"
+#include "ntru_igf.h"
+
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+#include <immintrin.h>
+#endif
+
+
+// The macro TARGET_AVX2 enables AVX2 for a single function when the compiler
+// supports the target attribute (see ring_arith.c).
+
+#if defined(AVRNTRU_X86_TARGETS)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+
+// The macros ROTR32, BSIG0, BSIG1, SSIG0, and SSIG1 implement the rotation and
+// the four "sigma" functions of SHA-256 as specified in FIPS 180-4, while the
+// macro LOAD32_BE loads a 32-bit word in big-endian byte order.
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define BSIG0(x) (ROTR32(x, 2) ^ ROTR32(x, 13) ^ ROTR32(x, 22))
+#define BSIG1(x) (ROTR32(x, 6) ^ ROTR32(x, 11) ^ ROTR32(x, 25))
+#define SSIG0(x) (ROTR32(x, 7) ^ ROTR32(x, 18) ^ ((x) >> 3))
+#define SSIG1(x) (ROTR32(x, 17) ^ ROTR32(x, 19) ^ ((x) >> 10))
+#define LOAD32_BE(p) (((uint32_t) (p)[0] << 24) | ((uint32_t) (p)[1] << 16) \
+                      | ((uint32_t) (p)[2] << 8) | (uint32_t) (p)[3])
+
+
+// Round constants and initial hash value of SHA-256.
+
+static const uint32_t sha256_k[64] = {
+  0x428A2F98UL, 0x71374491UL, 0xB5C0FBCFUL, 0xE9B5DBA5UL, 0x3956C25BUL,
+  0x59F111F1UL, 0x923F82A4UL, 0xAB1C5ED5UL, 0xD807AA98UL, 0x12835B01UL,
+  0x243185BEUL, 0x550C7DC3UL, 0x72BE5D74UL, 0x80DEB1FEUL, 0x9BDC06A7UL,
+  0xC19BF174UL, 0xE49B69C1UL, 0xEFBE4786UL, 0x0FC19DC6UL, 0x240CA1CCUL,
+  0x2DE92C6FUL, 0x4A7484AAUL, 0x5CB0A9DCUL, 0x76F988DAUL, 0x983E5152UL,
+  0xA831C66DUL, 0xB00327C8UL, 0xBF597FC7UL, 0xC6E00BF3UL, 0xD5A79147UL,
+  0x06CA6351UL, 0x14292967UL, 0x27B70A85UL, 0x2E1B2138UL, 0x4D2C6DFCUL,
+  0x53380D13UL, 0x650A7354UL, 0x766A0ABBUL, 0x81C2C92EUL, 0x92722C85UL,
+  0xA2BFE8A1UL, 0xA81A664BUL, 0xC24B8B70UL, 0xC76C51A3UL, 0xD192E819UL,
+  0xD6990624UL, 0xF40E3585UL, 0x106AA070UL, 0x19A4C116UL, 0x1E376C08UL,
+  0x2748774CUL, 0x34B0BCB5UL, 0x391C0CB3UL, 0x4ED8AA4AUL, 0x5B9CCA4FUL,
+  0x682E6FF3UL, 0x748F82EEUL, 0x78A5636FUL, 0x84C87814UL, 0x8CC70208UL,
+  0x90BEFFFAUL, 0xA4506CEBUL, 0xBEF9A3F7UL, 0xC67178F2UL
+};
+
+static const uint32_t sha256_iv[8] = {
+  0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL, 0x510E527FUL,
+  0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+};
+
+
+// Struct for the state of the index generation for one seed. The indices are
+// written to the array <out>, whereby <pos> is the number of indices that
+// have been generated so far. The bitmap <map> has a bit for each possible
+// index and is used to detect duplicates within a sub-polynomial; it is
+// cleared whenever the indices of a sub-polynomial are complete.
+
+typedef struct igf_lane {
+  uint16_t *out;      // array for the indices of the product-form polynomial
+  int pos;            // number of indices generated so far
+  uint8_t map[(AVRNTRU_MAX_DIM + 7)/8];  // bitmap of the indices in use
+} igf_lane_t;
+
+
+// The function <sha256_compress_c99> updates the SHA-256 state <state> of
+// eight 32-bit words with the 64-byte block <block>. The message schedule is
+// computed on the fly in a circular buffer of 16 words, which keeps the RAM
+// footprint small on AVR (the execution time does not depend on the data).
+
+void sha256_compress_c99(uint32_t *state, const uint8_t *block)
+{
+  uint32_t w[16], a, b, c, d, e, f, g, h, t1, t2;
+  int t;
+
+  for (t = 0; t < 16; t ++) w[t] = LOAD32_BE(&block[4*t]);
+  a = state[0]; b = state[1]; c = state[2]; d = state[3];
+  e = state[4]; f = state[5]; g = state[6]; h = state[7];
+  for (t = 0; t < 64; t ++) {
+    if (t >= 16) {
+      w[t&15] += SSIG1(w[(t+14)&15]) + w[(t+9)&15] + SSIG0(w[(t+1)&15]);
+    }
+    t1 = h + BSIG1(e) + ((e & f) ^ (~e & g)) + sha256_k[t] + w[t&15];
+    t2 = BSIG0(a) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g; g = f; f = e; e = d + t1;
+    d = c; c = b; b = a; a = t1 + t2;
+  }
+  state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+  state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+
+// The function <sha256_compress_x8_c99> updates eight independent SHA-256
+// states with one block each. The states are interleaved, i.e. word i of the
+// state of lane l is state[8*i+l], and <block> is an array of eight pointers
+// to 64-byte blocks. This is the layout of the AVX2 version; the C version
+// simply processes one lane after the other and is used on platforms without
+// AVX2 (see config.h).
+
+void sha256_compress_x8_c99(uint32_t *state, const uint8_t *block[])
+{
+  uint32_t st[8];
+  int i, l;
+
+  for (l = 0; l < 8; l ++) {
+    for (i = 0; i < 8; i ++) st[i] = state[8*i+l];
+    sha256_compress_c99(st, block[l]);
+    for (i = 0; i < 8; i ++) state[8*i+l] = st[i];
+  }
+}
+
+
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+
+// The macros ROTR32_X8, BSIG0_X8, etc. are the vectorized counterparts of the
+// SHA-256 macros above and operate on eight 32-bit words in a YMM register.
+
+#define ROTR32_X8(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), \
+                                        _mm256_slli_epi32(x, 32 - (n)))
+#define XOR3_X8(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define BSIG0_X8(x) XOR3_X8(ROTR32_X8(x, 2), ROTR32_X8(x, 13), \
+                            ROTR32_X8(x, 22))
+#define BSIG1_X8(x) XOR3_X8(ROTR32_X8(x, 6), ROTR32_X8(x, 11), \
+                            ROTR32_X8(x, 25))
+#define SSIG0_X8(x) XOR3_X8(ROTR32_X8(x, 7), ROTR32_X8(x, 18), \
+                            _mm256_srli_epi32(x, 3))
+#define SSIG1_X8(x) XOR3_X8(ROTR32_X8(x, 17), ROTR32_X8(x, 19), \
+                            _mm256_srli_epi32(x, 10))
+#define ADD_X8(x, y) _mm256_add_epi32(x, y)
+
+
+// The function <sha256_compress_x8_avx2> is a vectorized implementation of
+// the function <sha256_compress_x8_c99> for x86-64 processors with AVX2, i.e.
+// each YMM register holds the same variable of the eight SHA-256 instances
+// ("multi-buffer" hashing). The message words of the eight blocks are loaded
+// in transposed order, which is done with scalar loads since the blocks may
+// be located anywhere in memory.
+
+TARGET_AVX2
+void sha256_compress_x8_avx2(uint32_t *state, const uint8_t *block[])
+{
+  __m256i w[16], s[8], a, b, c, d, e, f, g, h, t1, t2;
+  int i, t;
+
+  for (t = 0; t < 16; t ++) {
+    w[t] = _mm256_setr_epi32((int) LOAD32_BE(&block[0][4*t]), \
+      (int) LOAD32_BE(&block[1][4*t]), (int) LOAD32_BE(&block[2][4*t]), \
+      (int) LOAD32_BE(&block[3][4*t]), (int) LOAD32_BE(&block[4][4*t]), \
+      (int) LOAD32_BE(&block[5][4*t]), (int) LOAD32_BE(&block[6][4*t]), \
+      (int) LOAD32_BE(&block[7][4*t]));
+  }
+  for (i = 0; i < 8; i ++)
+    s[i] = _mm256_loadu_si256((const __m256i *) &state[8*i]);
+  a = s[0]; b = s[1]; c = s[2]; d = s[3];
+  e = s[4]; f = s[5]; g = s[6]; h = s[7];
+  for (t = 0; t < 64; t ++) {
+    if (t >= 16) {
+      w[t&15] = ADD_X8(ADD_X8(w[t&15], SSIG1_X8(w[(t+14)&15])), \
+                       ADD_X8(w[(t+9)&15], SSIG0_X8(w[(t+1)&15])));
+    }
+    t1 = ADD_X8(ADD_X8(h, BSIG1_X8(e)), _mm256_xor_si256( \
+         _mm256_and_si256(e, f), _mm256_andnot_si256(e, g)));
+    t1 = ADD_X8(t1, ADD_X8(_mm256_set1_epi32((int) sha256_k[t]), w[t&15]));
+    t2 = ADD_X8(BSIG0_X8(a), XOR3_X8(_mm256_and_si256(a, b), \
+         _mm256_and_si256(a, c), _mm256_and_si256(b, c)));
+    h = g; g = f; f = e; e = ADD_X8(d, t1);
+    d = c; c = b; b = a; a = ADD_X8(t1, t2);
+  }
+  s[0] = ADD_X8(s[0], a); s[1] = ADD_X8(s[1], b);
+  s[2] = ADD_X8(s[2], c); s[3] = ADD_X8(s[3], d);
+  s[4] = ADD_X8(s[4], e); s[5] = ADD_X8(s[5], f);
+  s[6] = ADD_X8(s[6], g); s[7] = ADD_X8(s[7], h);
+  for (i = 0; i < 8; i ++)
+    _mm256_storeu_si256((__m256i *) &state[8*i], s[i]);
+}
+
+#endif  // defined(__AVX2__) || ...
+
+
+// The function <igf_prepare> prepares the hashing of the strings seed||ctr
+// for a seed of <seedlen> bytes and a 4-byte counter ctr (big-endian). The
+// complete 64-byte blocks of the seed are the same for every counter, so they
+// are compressed only once by the caller, which yields the "midstate". The
+// remaining bytes of the seed are copied to the array <fin> of 128 bytes,
+// followed by the (still empty) counter and the SHA-256 padding. The function
+// returns the number of final blocks (1 or 2) that have to be compressed for
+// each counter.
+
+static int igf_prepare(uint8_t *fin, const uint8_t *seed, int seedlen)
+{
+  int i, tail = seedlen & 63, nfin = (tail + 4 + 9 <= 64) ? 1 : 2;
+  uint32_t bits = 8*((uint32_t) seedlen + 4);
+
+  for (i = 0; i < 64*nfin; i ++) fin[i] = 0;
+  for (i = 0; i < tail; i ++) fin[i] = seed[seedlen - tail + i];
+  fin[tail+4] = 0x80;
+  for (i = 0; i < 4; i ++) fin[64*nfin-1-i] = (uint8_t) (bits >> (8*i));
+
+  return nfin;
+}
+
+
+// The function <igf_consume> extracts indices from the 32-byte hash value
+// <md>, which is interpreted as a string of bits (starting with the least-
+// significant bit of md[0]) and split up into c-bit candidates, where c is
+// the bit-length of N-1 (e.g. c = 9 for N = 401). The bits of an incomplete
+// candidate at the end of the hash value are discarded. A candidate v is
+// rejected when v >= N (rejection sampling, so that all indices are equally
+// likely) or when the bitmap shows that v is already an index of the current
+// sub-polynomial (duplicate detection). The function returns 1 when all the
+// indices of the product-form polynomial have been generated and 0 when more
+// hash values are needed.
+
+static int igf_consume(igf_lane_t *lane, const uint8_t *md, int c,
+                       const ntru_params_t *p)
+{
+  int k, bits = 0, N = p->N, end1, end2, total;
+  uint32_t acc = 0, v;
+
+  end1 = 2*p->df1;
+  end2 = end1 + 2*p->df2;
+  total = NTRU_IGF_LEN(p);
+  for (k = 0; (k < 32) && (lane->pos < total); k ++) {
+    acc |= ((uint32_t) md[k]) << bits;
+    bits += 8;
+    while ((bits >= c) && (lane->pos < total)) {
+      v = acc & ((1UL << c) - 1);
+      acc >>= c;
+      bits -= c;
+      if (v >= (uint32_t) N) continue;
+      if ((lane->map[v >> 3] >> (v & 7)) & 1) continue;
+      lane->map[v >> 3] |= (uint8_t) (1 << (v & 7));
+      lane->out[lane->pos++] = (uint16_t) v;
+      // the indices of a sub-polynomial are complete
+      if ((lane->pos == end1) || (lane->pos == end2)) {
+        for (v = 0; v < (uint32_t) (N + 7)/8; v ++) lane->map[v] = 0;
+      }
+    }
+  }
+
+  return (lane->pos == total);
+}
+
+
+// The function <igf_init> initializes the state of the index generation for
+// the array <out> and returns the bit-length c of N-1.
+
+static int igf_init(igf_lane_t *lane, uint16_t *out, int N)
+{
+  int i, c;
+
+  lane->out = out;
+  lane->pos = 0;
+  for (i = 0; i < (N + 7)/8; i ++) lane->map[i] = 0;
+  for (c = 1; ((N - 1) >> c) != 0; c ++);
+
+  return c;
+}
+
+
+// The function <ntru_gen_indices> generates the indices of the non-0 coeffs
+// of a product-form polynomial for the parameter set <p> (e.g. the blinding
+// polynomial r(x) = r1(x)*r2(x) + r3(x) of the encryption) from the seed
+// <seed> of <seedlen> bytes. The NTRU_IGF_LEN(p) indices are written to the
+// array <indices> in the layout of a prod_form_poly_t with 2*df1, 2*df2, and
+// 2*df3 non-0 coefficients of the three sub-polynomials, whereby the indices
+// within a sub-polynomial are distinct. The indices are derived from the
+// hash values SHA-256(seed||ctr) for ctr = 0, 1, 2, ... (see igf_consume).
+// Since rejected candidates require further hash values, the execution time
+// depends on the seed; it does not depend on the positions of the accepted
+// indices, except for the bitmap accesses on processors with a data cache.
+
+void ntru_gen_indices(uint16_t *indices, const uint8_t *seed, int seedlen,
+                      const ntru_params_t *p)
+{
+  int i, c, nfin, tail = seedlen & 63, done = 0;
+  uint32_t mid[8], st[8], ctr;
+  uint8_t fin[128], md[32];
+  igf_lane_t lane;
+
+  c = igf_init(&lane, indices, p->N);
+  nfin = igf_prepare(fin, seed, seedlen);
+  // midstate of the complete 64-byte blocks of the seed
+  for (i = 0; i < 8; i ++) mid[i] = sha256_iv[i];
+  for (i = 0; i + 64 <= seedlen; i += 64) sha256_compress_c99(mid, &seed[i]);
+  for (ctr = 0; !done; ctr ++) {
+    for (i = 0; i < 4; i ++) fin[tail+i] = (uint8_t) (ctr >> (24 - 8*i));
+    for (i = 0; i < 8; i ++) st[i] = mid[i];
+    sha256_compress_c99(st, fin);
+    if (nfin == 2) sha256_compress_c99(st, &fin[64]);
+    for (i = 0; i < 32; i ++) md[i] = (uint8_t) (st[i/4] >> (24 - 8*(i&3)));
+    done = igf_consume(&lane, md, c, p);
+  }
+}
+
+
+// The function <ntru_gen_indices_multi> generates the indices for <num> seeds
+// (at most NTRU_IGF_MAX_LANES) of the same length in parallel, whereby the
+// indices for seed[l] are written to indices[l]. The results are the same as
+// those of <ntru_gen_indices>, but the hash values for a counter are computed
+// for all seeds with a single call of the multi-buffer SHA-256 compression
+// (also the midstates), which makes the index generation for eight seeds more
+// than twice as fast with AVX2 as eight calls of <ntru_gen_indices>. The
+// seeds that need fewer hash values than the others are carried along until
+// all seeds are done (their hash values are discarded). This function is not
+// intended for AVR, where the multi-buffer compression would only increase
+// the RAM footprint.
+
+void ntru_gen_indices_multi(uint16_t *indices[], const uint8_t *seed[],
+                            int seedlen, int num, const ntru_params_t *p)
+{
+  int i, l, c = 0, nfin = 1, tail = seedlen & 63, done = 0, k;
+  uint32_t mid[64], st[64], ctr;
+  uint8_t fin[NTRU_IGF_MAX_LANES][128], md[32];
+  const uint8_t *blk[8];
+  igf_lane_t lane[NTRU_IGF_MAX_LANES];
+  int busy[NTRU_IGF_MAX_LANES];
+
+  for (l = 0; l < num; l ++) {
+    c = igf_init(&lane[l], indices[l], p->N);
+    nfin = igf_prepare(fin[l], seed[l], seedlen);
+    busy[l] = 1;
+  }
+  // midstates of the complete 64-byte blocks of the seeds (unused lanes
+  // compress the blocks of lane 0)
+  for (i = 0; i < 64; i ++) mid[i] = sha256_iv[i/8];
+  for (k = 0; k + 64 <= seedlen; k += 64) {
+    for (l = 0; l < 8; l ++) blk[l] = &seed[(l < num) ? l : 0][k];
+    sha256_compress_x8(mid, blk);
+  }
+  for (ctr = 0; done < num; ctr ++) {
+    for (l = 0; l < num; l ++)
+      for (i = 0; i < 4; i ++) fin[l][tail+i] = (uint8_t) (ctr >> (24-8*i));
+    for (i = 0; i < 64; i ++) st[i] = mid[i];
+    for (k = 0; k < nfin; k ++) {
+      for (l = 0; l < 8; l ++) blk[l] = &fin[(l < num) ? l : 0][64*k];
+      sha256_compress_x8(st, blk);
+    }
+    for (l = 0; l < num; l ++) {
+      if (!busy[l]) continue;
+      for (i = 0; i < 32; i ++)
+        md[i] = (uint8_t) (st[8*(i/4)+l] >> (24 - 8*(i&3)));
+      if (igf_consume(&lane[l], md, c, p)) { busy[l] = 0; done ++; }
+    }
+  }
+}
@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_igf.h: Index Generation for Product-Form Polynomials.                //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_NTRU_IGF_H
+#define AVRNTRU_NTRU_IGF_H
+
+#include "typedefs.h"
+#include "config.h"
+#include "ntru_encrypt.h"
+
+// Maximum number of seeds (i.e. messages) that can be processed in parallel
+// by <ntru_gen_indices_multi>, which corresponds to the number of 32-bit lanes
+// of an AVX2 register.
+
+#define NTRU_IGF_MAX_LANES 8
+
+// Number of indices generated for a product-form polynomial of parameter set
+// <p>, i.e. the length of the array <indices> of a prod_form_poly_t.
+
+#define NTRU_IGF_LEN(p) (2*((p)->df1 + (p)->df2 + (p)->df3))
+
+// Function prototypes
+
+void sha256_compress_c99(uint32_t *state, const uint8_t *block);
+void sha256_compress_x8_c99(uint32_t *state, const uint8_t *block[]);
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+void sha256_compress_x8_avx2(uint32_t *state, const uint8_t *block[]);
+#endif
+void ntru_gen_indices(uint16_t *indices, const uint8_t *seed, int seedlen,
+                      const ntru_params_t *p);
+void ntru_gen_indices_multi(uint16_t *indices[], const uint8_t *seed[],
+                            int seedlen, int num, const ntru_params_t *p);
+
+#endif  // AVRNTRU_NTRU_IGF_H
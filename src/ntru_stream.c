@@ -0,0 +1,304 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_stream.c: Streaming Encryption of Large Payloads.                    //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stddef.h>
+#include "config.h"
+#include "ntru_stream.h"
+
+
+#define NTRU_STREAM_ENC 0
+#define NTRU_STREAM_DEC 1
+
+// Struct for a call of <ntru_stream_encrypt> or <ntru_stream_decrypt>. The
+// payload (plaintext) consists of <len> bytes and <nblk> blocks. For an
+// encryption, <in> points to the plaintext and <out> to the ciphertext, and
+// vice versa for a decryption. The error codes of the blocks are OR-ed into
+// <err>, separately for each thread.
+
+typedef struct stream_job {
+  ntru_stream_ctx_t *ctx;     // context of the stream
+  int op;                     // NTRU_STREAM_ENC or NTRU_STREAM_DEC
+  const uint8_t *in;          // input (plaintext or packed ciphertext)
+  uint8_t *out;               // output (packed ciphertext or plaintext)
+  long len;                   // length of the payload in bytes
+  long nblk;                  // number of blocks of the payload
+  long bat;                   // number of the batch processed by stage 2
+  int err[AVRNTRU_MAX_THREADS];  // error codes of the threads
+} stream_job_t;
+
+
+// The function <stream_block> returns a pointer to the section of the arena
+// that belongs to block <k> of the batch in slot <slot>; the indices of the
+// blinding polynomial are at the beginning and the ciphertext e(x) follows at
+// offset 3*AVRNTRU_MAX_NZC.
+
+static uint16_t *stream_block(const ntru_stream_ctx_t *ctx, long bat, int k)
+{
+  int N = ctx->p->N;
+  long slot = bat % NTRU_STREAM_SLOTS;
+
+  return &ctx->arena[(slot*NTRU_STREAM_BATCH + k)*NTRU_STREAM_BLOCK_LEN(N)];
+}
+
+
+// The function <stream_stage1> executes the first stage for the batch <bat>,
+// i.e. the generation of the indices of the blinding polynomials of all its
+// blocks (encryption) or the unpacking of their ciphertexts (decryption). The
+// seeds of the index generation are the seed of the context followed by the
+// block number, and all blocks of the batch are processed in parallel by
+// <ntru_gen_indices_multi>.
+
+static void stream_stage1(stream_job_t *job, long bat)
+{
+  ntru_stream_ctx_t *ctx = job->ctx;
+  const ntru_params_t *p = ctx->p;
+  int i, k, cnt, N = p->N, slen = ctx->seedlen + 4;
+  long b, b0 = bat*NTRU_STREAM_BATCH;
+  uint8_t seeds[NTRU_STREAM_BATCH][NTRU_STREAM_MAX_SEED+4];
+  const uint8_t *ps[NTRU_STREAM_BATCH];
+  uint16_t *pi[NTRU_STREAM_BATCH];
+  uint32_t ctr;
+
+  cnt = (job->nblk - b0 < NTRU_STREAM_BATCH) ? (int) (job->nblk - b0) : \
+        NTRU_STREAM_BATCH;
+  if (job->op == NTRU_STREAM_DEC) {
+    for (k = 0; k < cnt; k ++) {
+      b = b0 + k;
+      ring_unpack(&stream_block(ctx, bat, k)[3*AVRNTRU_MAX_NZC], \
+                  &job->in[b*RING_PACKED_LEN(N)], N);
+    }
+    return;
+  }
+  for (k = 0; k < cnt; k ++) {
+    ctr = ctx->ctr + (uint32_t) (b0 + k);
+    for (i = 0; i < ctx->seedlen; i ++) seeds[k][i] = ctx->seed[i];
+    seeds[k][i  ] = (uint8_t) (ctr >> 24);
+    seeds[k][i+1] = (uint8_t) (ctr >> 16);
+    seeds[k][i+2] = (uint8_t) (ctr >> 8);
+    seeds[k][i+3] = (uint8_t) ctr;
+    ps[k] = seeds[k];
+    pi[k] = stream_block(ctx, bat, k);
+  }
+  if (cnt == 1) ntru_gen_indices(pi[0], ps[0], slen, p);
+  else ntru_gen_indices_multi(pi, ps, slen, cnt, p);
+}
+
+
+// The function <stream_stage2> executes the second stage for the blocks <k0>
+// to <k1>-1 of the batch <bat>, i.e. the encryption and packing (resp. the
+// decryption) of each block. The encryption of a block reuses its section of
+// the arena for the ciphertext e(x), and the packed ciphertext is written
+// directly to the output. The error codes are OR-ed into <*err>.
+
+static void stream_stage2(stream_job_t *job, long bat, int k0, int k1,
+                          int *err)
+{
+  ntru_stream_ctx_t *ctx = job->ctx;
+  const ntru_params_t *p = ctx->p;
+  int k, mlen, N = p->N;
+  long b;
+  uint16_t *blk;
+  prod_form_poly_t r;
+
+  for (k = k0; k < k1; k ++) {
+    b = bat*NTRU_STREAM_BATCH + k;
+    blk = stream_block(ctx, bat, k);
+    mlen = (job->len - b*p->maxmsglen < p->maxmsglen) ? \
+           (int) (job->len - b*p->maxmsglen) : p->maxmsglen;
+    if (job->op == NTRU_STREAM_ENC) {
+      r.indices = blk;
+      r.num_nzc_poly1 = 2*p->df1;
+      r.num_nzc_poly2 = 2*p->df2;
+      r.num_nzc_poly3 = 2*p->df3;
+      *err |= ntru_encrypt(&blk[3*AVRNTRU_MAX_NZC], &job->in[b*p->maxmsglen], \
+                           mlen, &r, ctx->pk);
+      ring_pack(&job->out[b*RING_PACKED_LEN(N)], &blk[3*AVRNTRU_MAX_NZC], N);
+    } else {
+      *err |= ntru_decrypt(&job->out[b*p->maxmsglen], mlen, \
+                           &blk[3*AVRNTRU_MAX_NZC], ctx->F, p);
+    }
+  }
+}
+
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+
+// The job-function <stream_main> is executed by every thread of the pool and
+// implements one step of the pipeline: thread 0 executes the first stage of
+// the next batch (if there is one), while the other threads share the blocks
+// of the current batch <job->bat> for the second stage. Since the two batches
+// reside in different slots of the arena, the two stages are independent.
+
+static void stream_main(void *arg, int id, int num)
+{
+  stream_job_t *job = (stream_job_t *) arg;
+  long b0 = job->bat*NTRU_STREAM_BATCH;
+  int cnt;
+
+  cnt = (job->nblk - b0 < NTRU_STREAM_BATCH) ? (int) (job->nblk - b0) : \
+        NTRU_STREAM_BATCH;
+  if (id == 0) {
+    if ((job->bat + 1)*NTRU_STREAM_BATCH < job->nblk)
+      stream_stage1(job, job->bat + 1);
+  } else {
+    stream_stage2(job, job->bat, ((id - 1)*cnt)/(num - 1), \
+                  (id*cnt)/(num - 1), &job->err[id]);
+  }
+}
+
+#endif  // defined(AVRNTRU_USE_THREADS) && ...
+
+
+// The function <stream_run> processes a section of <len> bytes of a payload,
+// batch by batch. Without thread pool, the two stages of each batch are simply
+// executed one after the other. With a pool of at least two threads, the first
+// stage of batch j+1 is overlapped with the second stage of batch j (see
+// stream_main). Only a section whose length is not a multiple of the block
+// size (i.e. whose last block is shorter) can be the last one of a payload.
+
+static int stream_run(ntru_stream_ctx_t *ctx, uint8_t *out,
+                      const uint8_t *in, long len, int op)
+{
+  stream_job_t job;
+  long nbat;
+  int i, cnt, err = AVRNTRU_NO_ERROR;
+
+  if ((len < 0) || (ctx->final && (len > 0))) return AVRNTRU_ERR_MSGLEN;
+  if (len % ctx->p->maxmsglen) ctx->final = 1;
+  job.ctx = ctx; job.op = op; job.in = in; job.out = out; job.len = len;
+  job.nblk = (len + ctx->p->maxmsglen - 1)/ctx->p->maxmsglen;
+  for (i = 0; i < AVRNTRU_MAX_THREADS; i ++) job.err[i] = AVRNTRU_NO_ERROR;
+  nbat = (job.nblk + NTRU_STREAM_BATCH - 1)/NTRU_STREAM_BATCH;
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+  if ((ctx->pool != NULL) && (ctx->pool->num_threads > 1) && (nbat > 0)) {
+    stream_stage1(&job, 0);
+    for (job.bat = 0; job.bat < nbat; job.bat ++)
+      ring_pool_run(ctx->pool, stream_main, &job);
+    for (i = 0; i < ctx->pool->num_threads; i ++) err |= job.err[i];
+    ctx->ctr += (uint32_t) job.nblk;
+    return err;
+  }
+#endif
+
+  for (job.bat = 0; job.bat < nbat; job.bat ++) {
+    cnt = (job.nblk - job.bat*NTRU_STREAM_BATCH < NTRU_STREAM_BATCH) ? \
+          (int) (job.nblk - job.bat*NTRU_STREAM_BATCH) : NTRU_STREAM_BATCH;
+    stream_stage1(&job, job.bat);
+    stream_stage2(&job, job.bat, 0, cnt, &err);
+  }
+  ctx->ctr += (uint32_t) job.nblk;
+
+  return err;
+}
+
+
+// The function <ntru_stream_init_enc> sets up the context <ctx> for the
+// encryption of a payload under the prepared public key <pk>. The blinding
+// polynomials are derived from the <seedlen> bytes of <seed>, which must be
+// random and must not be used for more than one payload. The arena <arena>
+// must consist of NTRU_STREAM_ARENA_LEN(N) elements. AVRNTRU_ERR_MSGLEN is
+// returned when the seed is longer than NTRU_STREAM_MAX_SEED bytes.
+
+int ntru_stream_init_enc(ntru_stream_ctx_t *ctx, uint16_t *arena,
+                         const ntru_pubkey_ctx_t *pk, const uint8_t *seed,
+                         int seedlen)
+{
+  int i;
+
+  if ((seedlen < 0) || (seedlen > NTRU_STREAM_MAX_SEED))
+    return AVRNTRU_ERR_MSGLEN;
+  ctx->p = pk->p;
+  ctx->pk = pk;
+  ctx->F = NULL;
+  ctx->arena = arena;
+  for (i = 0; i < seedlen; i ++) ctx->seed[i] = seed[i];
+  ctx->seedlen = seedlen;
+  ctx->ctr = 0;
+  ctx->final = 0;
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+  ctx->pool = NULL;
+#endif
+
+  return AVRNTRU_NO_ERROR;
+}
+
+
+// The function <ntru_stream_init_dec> sets up the context <ctx> for the
+// decryption of a payload with the private key F(x) of parameter set <p>. The
+// arena <arena> must consist of NTRU_STREAM_ARENA_LEN(N) elements.
+
+void ntru_stream_init_dec(ntru_stream_ctx_t *ctx, uint16_t *arena,
+                          const prod_form_poly_t *F, const ntru_params_t *p)
+{
+  ctx->p = p;
+  ctx->pk = NULL;
+  ctx->F = F;
+  ctx->arena = arena;
+  ctx->seedlen = 0;
+  ctx->ctr = 0;
+  ctx->final = 0;
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+  ctx->pool = NULL;
+#endif
+}
+
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+
+// The function <ntru_stream_set_pool> assigns the thread pool <pool> to the
+// context <ctx>, which enables the overlapping of the stages (see stream_run).
+// The pool can be shared by several contexts, but a pool must not be used by
+// two streams at the same time.
+
+void ntru_stream_set_pool(ntru_stream_ctx_t *ctx, ring_pool_t *pool)
+{
+  ctx->pool = pool;
+}
+
+#endif  // defined(AVRNTRU_USE_THREADS) && ...
+
+
+// The function <ntru_stream_encrypt> encrypts the next <len> bytes of the
+// payload given by <in> and writes NTRU_STREAM_CTLEN(p, len) bytes of packed
+// ciphertexts to <out>. A payload can be passed in sections of any length
+// that is a multiple of p->maxmsglen, followed by a last section of arbitrary
+// length; the peak RAM is the same for all lengths. AVRNTRU_ERR_MSGLEN is
+// returned when a section follows a section with a shorter last block.
+
+int ntru_stream_encrypt(ntru_stream_ctx_t *ctx, uint8_t *out,
+                        const uint8_t *in, long len)
+{
+  return stream_run(ctx, out, in, len, NTRU_STREAM_ENC);
+}
+
+
+// The function <ntru_stream_decrypt> decrypts the packed ciphertexts of the
+// next <len> bytes of the payload, i.e. it reads NTRU_STREAM_CTLEN(p, len)
+// bytes from <in> and writes <len> bytes to <out>. The sections must have the
+// same lengths as in the encryption. When one of the blocks can not be
+// decoded, AVRNTRU_ERR_DECODE is returned (the other blocks are nonetheless
+// decrypted).
+
+int ntru_stream_decrypt(ntru_stream_ctx_t *ctx, uint8_t *out,
+                        const uint8_t *in, long len)
+{
+  return stream_run(ctx, out, in, len, NTRU_STREAM_DEC);
+}
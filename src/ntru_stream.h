@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_stream.h: Streaming Encryption of Large Payloads.                    //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_NTRU_STREAM_H
+#define AVRNTRU_NTRU_STREAM_H
+
+#include "typedefs.h"
+#include "config.h"
+#include "ntru_encrypt.h"
+#include "ntru_igf.h"
+#include "ring_pack.h"
+#include "ring_mt.h"
+
+// A payload is split up into blocks of p->maxmsglen bytes (the last block may
+// be shorter), each of which is encrypted into a packed ciphertext of
+// RING_PACKED_LEN(N) bytes. The blocks are processed in batches of
+// NTRU_STREAM_BATCH blocks, whereby the index generation of a batch is done
+// with the multi-buffer SHA-256 on the host; on AVR, a batch consists of one
+// block. When AVRNTRU_USE_THREADS is defined, the scratch arena holds
+// NTRU_STREAM_SLOTS = 2 batches so that the first stage of the next batch
+// (index generation resp. unpacking) can overlap with the second stage of the
+// current one (encryption and packing resp. decryption).
+
+#if defined(__AVR__)
+#define NTRU_STREAM_BATCH 1
+#else
+#define NTRU_STREAM_BATCH NTRU_IGF_MAX_LANES
+#endif
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+#define NTRU_STREAM_SLOTS 2
+#else
+#define NTRU_STREAM_SLOTS 1
+#endif
+
+// Maximum length of the seed (in bytes) from which the blinding polynomials of
+// the blocks are derived, not including the 32-bit block counter
+
+#define NTRU_STREAM_MAX_SEED 64
+
+// Number of 16-bit elements of the scratch arena for the dimension <N>. Each
+// block of a batch needs the indices of its blinding polynomial (at most
+// 3*AVRNTRU_MAX_NZC) and a ciphertext e(x) of N+7 elements (rounded up to an
+// even number). The length does not depend on the size of the payload.
+
+#define NTRU_STREAM_BLOCK_LEN(N) (3*AVRNTRU_MAX_NZC + (N) + 8)
+#define NTRU_STREAM_ARENA_LEN(N) \
+  (NTRU_STREAM_SLOTS*NTRU_STREAM_BATCH*NTRU_STREAM_BLOCK_LEN(N))
+
+// Length (in bytes) of the ciphertext of a payload of <len> bytes for the
+// parameter set <p>
+
+#define NTRU_STREAM_CTLEN(p, len) \
+  ((((len) + (p)->maxmsglen - 1)/(p)->maxmsglen)*RING_PACKED_LEN((p)->N))
+
+// Struct for the context of a streaming encryption or decryption. It is set up
+// with <ntru_stream_init_enc> or <ntru_stream_init_dec>, whereby the arena of
+// NTRU_STREAM_ARENA_LEN(N) elements is provided by the caller and used for
+// all blocks. The blinding polynomial of the block with number k (counted
+// from the start of the payload) is derived from the seed followed by k as a
+// 32-bit big-endian integer. The members should be considered private.
+
+typedef struct ntru_stream_ctx {
+  const ntru_params_t *p;     // parameter set
+  const ntru_pubkey_ctx_t *pk;  // prepared public key (only for encryption)
+  const prod_form_poly_t *F;  // private key F(x) (only for decryption)
+  uint16_t *arena;            // scratch arena of NTRU_STREAM_ARENA_LEN(N)
+  uint8_t seed[NTRU_STREAM_MAX_SEED];  // seed of the blinding polynomials
+  int seedlen;                // length of the seed in bytes
+  uint32_t ctr;               // number of blocks processed so far
+  int final;                  // 1 when the last block was shorter than a block
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+  ring_pool_t *pool;          // thread pool (NULL: single-threaded)
+#endif
+} ntru_stream_ctx_t;
+
+// Function prototypes
+
+int ntru_stream_init_enc(ntru_stream_ctx_t *ctx, uint16_t *arena,
+                         const ntru_pubkey_ctx_t *pk, const uint8_t *seed,
+                         int seedlen);
+void ntru_stream_init_dec(ntru_stream_ctx_t *ctx, uint16_t *arena,
+                          const prod_form_poly_t *F, const ntru_params_t *p);
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+void ntru_stream_set_pool(ntru_stream_ctx_t *ctx, ring_pool_t *pool);
+#endif
+int ntru_stream_encrypt(ntru_stream_ctx_t *ctx, uint8_t *out,
+                        const uint8_t *in, long len);
+int ntru_stream_decrypt(ntru_stream_ctx_t *ctx, uint8_t *out,
+                        const uint8_t *in, long len);
+
+#endif  // AVRNTRU_NTRU_STREAM_H
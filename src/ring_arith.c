@@ -18,8 +18,14 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 
+#include <string.h>
 #include "config.h"
 #include "ring_arith.h"
+#include "stats.h"
+
+#if defined(__SSE2__) || defined(AVRNTRU_X86_TARGETS)
+#include <immintrin.h>
+#endif
 
 
 // The macro INTMASK(x) converts an integer x to an "all-1" mask when x = 1 and
@@ -28,20 +34,79 @@
 #define INTMASK(x) (~((x) - 1))
 
 
-// The following preprocessor directives define the length of two local arrays
-// in the ring arithmetic, namely array <index> in ring_mul_tern_sparse and <t>
-// in ring_mul_tern_prodform. Depending on AVRNTRU_USE_VLA, these lengths are
-// defined such that the concerned arrays become either Variable-Length Arrays
-// (VLAs) or static arrays (see config.h for further information).
+// The macro CENTER_MOD3(c) centers a coefficient c in [0, q-1] modulo q (i.e.
+// c becomes c - q when c >= q/2) and yields a non-negative integer that is
+// congruent to the centered coefficient modulo 3. No comparison is needed
+// since -q = -2^k is congruent to 1 (k odd) or 2 (k even) modulo 3, which
+// means it suffices to add bit k-1 of c (resp. twice this bit) to c.
+
+#define Q_NEG_MOD3 ((AVRNTRU_LOG_Q & 1) ? 1 : 2)
+#define CENTER_MOD3(c) ((c) + Q_NEG_MOD3*((c) >> (AVRNTRU_LOG_Q - 1)))
+
+
+// The macro FORCE_INLINE forces the compiler to inline a function, so that the
+// generic C99 kernels below can be instantiated with constant operand-lengths
+// and dimensions (see ring_mul_tern_sparse_401_16_c99 and the other kernels
+// for the standard parameter sets). The macro UNROLL_LOOP asks the compiler to
+// unroll the loop following it, which means the loop is completely unrolled in
+// the specialized kernels (constant number of iterations). It is only enabled
+// along with the specialized kernels since partial unrolling of the short
+// loops with variable length slows down the generic kernels by about 15% on
+// x86.
+
+#if defined(__GNUC__)
+#define FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline
+#endif
+
+#if defined(__GNUC__) && defined(AVRNTRU_SPECIALIZE)
+#define UNROLL_LOOP _Pragma("GCC unroll 16")
+#else
+#define UNROLL_LOOP
+#endif
+
+
+// The macros TARGET_SSE2, TARGET_AVX2, and TARGET_AVX512 enable the respective
+// instruction set for a single function when the vectorized kernels are built
+// for the run-time dispatch (see config.h), i.e. without options like -mavx2.
+// In all other cases they are empty.
+
+#if defined(AVRNTRU_X86_TARGETS)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+
+
+// The following preprocessor directives define the length of the local arrays
+// in the ring arithmetic, namely array <index> in ring_mul_tern_sparse, <t> in
+// ring_mul_tern_prodform, <index> in ring_mul_tern_sparse2, <t> in
+// ring_mul_tern_prodform_wide, and <sched> in ring_mul_tern_sparse_multi.
+// Depending on AVRNTRU_USE_VLA, these lengths are defined such that the
+// concerned arrays become either Variable-Length Arrays (VLAs) or static
+// arrays (see config.h for further information).
 
 #ifdef AVRNTRU_USE_VLA
 // Microsoft Visual C does not support VLAs
 #if !(defined(_MSC_VER) && !defined(__ICL))
 #define _vlen vlen
 #define _tlen (N + 7)
+#define _dlen (vlen1 + vlen2)
+#define _wlen (N + AVRNTRU_PUBKEY_PAD)
+#define _slen ((AVRNTRU_TILE_LEN/8)*vlen)
 #else  // static arrays are used
 #define _vlen AVRNTRU_MAX_NZC
 #define _tlen (AVRNTRU_MAX_DIM + 7)
+#define _dlen (2*AVRNTRU_MAX_NZC)
+#define _wlen (AVRNTRU_MAX_DIM + AVRNTRU_PUBKEY_PAD)
+#define _slen ((AVRNTRU_TILE_LEN/8)*AVRNTRU_MAX_NZC)
 #endif
 #endif
 
@@ -67,13 +132,16 @@
 // will contain arbitrary values and can be ignored. It is assumed that <z> has
 // been initialized to 0 before calling the function; if not, a MAC operation
 // of the form z(x) = z(x) + u(x)*v(x) is computed instead of a multiplication.
+// The actual computation is done by <ring_mul_tern_sparse_tmpl>, which is also
+// used to instantiate the specialized kernels for fixed <vlen> and <N>.
 
-void ring_mul_tern_sparse_c99(uint16_t *r, const uint16_t *u, const uint16_t *v,
-                              int vlen, int N)
+static FORCE_INLINE void ring_mul_tern_sparse_tmpl(uint16_t *r,
+  const uint16_t *u, const uint16_t *v, int vlen, int N)
 {
   int index[_vlen], i, j, idx;
   register uint16_t sum0, sum1, sum2, sum3, sum4, sum5, sum6, sum7;
 
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE, index);
   // compute index = -j mod N for every j for which coefficient v_j != 0
   for (i = 0; i < vlen; i ++)
     index[i] = INTMASK(v[i] != 0) & (N - v[i]);
@@ -83,6 +151,7 @@ void ring_mul_tern_sparse_c99(uint16_t *r, const uint16_t *u, const uint16_t *v,
     sum0 = r[i  ]; sum1 = r[i+1]; sum2 = r[i+2]; sum3 = r[i+3];
     sum4 = r[i+4]; sum5 = r[i+5]; sum6 = r[i+6]; sum7 = r[i+7];
     // process all "+1" coefficients of the sparse ternary polynomial v(x)
+    UNROLL_LOOP
     for (j = 0; j < vlen/2; j ++) {
       idx = index[j];
       sum0 += u[idx++]; sum1 += u[idx++]; sum2 += u[idx++]; sum3 += u[idx++];
@@ -90,6 +159,7 @@ void ring_mul_tern_sparse_c99(uint16_t *r, const uint16_t *u, const uint16_t *v,
       index[j] = idx - (INTMASK(idx >= N) & N);
     }
     // process all "-1" coefficients of the sparse ternary polynomial v(x)
+    UNROLL_LOOP
     for (j = vlen/2; j < vlen; j ++) {
       idx = index[j];
       sum0 -= u[idx++]; sum1 -= u[idx++]; sum2 -= u[idx++]; sum3 -= u[idx++];
@@ -102,6 +172,12 @@ void ring_mul_tern_sparse_c99(uint16_t *r, const uint16_t *u, const uint16_t *v,
   }
 }
 
+void ring_mul_tern_sparse_c99(uint16_t *r, const uint16_t *u, const uint16_t *v,
+                              int vlen, int N)
+{
+  ring_mul_tern_sparse_tmpl(r, u, v, vlen, N);
+}
+
 
 // The function <ring_mul_tern_sparse_V2> is a more compact implementation of
 // the function <ring_mul_tern_sparse_c99> above to show that a multiplication
@@ -113,6 +189,7 @@ void ring_mul_tern_sparse_V2(uint16_t *r, const uint16_t *u, const uint16_t *v,
 {
   int index[_vlen], i, j, k;
 
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE, index);
   // compute index = -j mod N for every j for which coefficient v_j != 0
   for (i = 0; i < vlen; i ++)
     index[i] = INTMASK(v[i] != 0) & (N - v[i]);
@@ -136,6 +213,349 @@ void ring_mul_tern_sparse_V2(uint16_t *r, const uint16_t *u, const uint16_t *v,
 }
 
 
+// The function <ring_mul_tern_sparse_swar> is a portable implementation of
+// the function <ring_mul_tern_sparse_c99> that uses "SIMD Within A Register"
+// (SWAR) techniques to speed up the multiplication on 64-bit processors that
+// lack (or do not allow to use) vector instructions. Four coefficients of u(x)
+// are fetched through a single 64-bit load and then split up into the two
+// even and the two odd coefficients, which are placed in the lower halves of
+// the two 32-bit "lanes" of a 64-bit word so that each lane has 16 bits of
+// headroom. The lanes of the accumulators are initialized with 2^31 so that
+// the subtraction of coefficients can never borrow from the upper lane. The
+// lower 16 bits of each lane are thus exactly the 16-bit coefficient-sums of
+// the C99 version (as long as vlen < 2^15), i.e. both versions produce the
+// same result. The lanes are not affected by the byte order of the processor
+// since the coefficients of r(x) are loaded and stored in the same way as
+// those of u(x). The arrays <r>, <u>, and <v> have the same format as in the
+// C99 version.
+
+#define SWAR_MASK 0x0000FFFF0000FFFFULL
+#define SWAR_BIAS 0x8000000080000000ULL
+
+#if AVRNTRU_MAX_NZC >= 32768
+#error "ring_mul_tern_sparse_swar requires AVRNTRU_MAX_NZC < 2^15"
+#endif
+
+static uint64_t load64(const uint16_t *a)
+{
+  uint64_t w;
+
+  memcpy(&w, a, sizeof(w));  // unaligned 64-bit load
+  return w;
+}
+
+static void store64(uint16_t *a, uint64_t w)
+{
+  memcpy(a, &w, sizeof(w));  // unaligned 64-bit store
+}
+
+void ring_mul_tern_sparse_swar(uint16_t *r, const uint16_t *u,
+                               const uint16_t *v, int vlen, int N)
+{
+  int index[_vlen], i, j, idx;
+  uint64_t even0, odd0, even1, odd1, w0, w1;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE, index);
+  // compute index = -j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++)
+    index[i] = INTMASK(v[i] != 0) & (N - v[i]);
+
+  for (i = 0; i < N; i += 8) {
+    // load eight coefficients of r(x) and distribute them over 8 lanes
+    w0 = load64(&r[i]); w1 = load64(&r[i+4]);
+    even0 = (w0 & SWAR_MASK) + SWAR_BIAS;
+    odd0 = ((w0 >> 16) & SWAR_MASK) + SWAR_BIAS;
+    even1 = (w1 & SWAR_MASK) + SWAR_BIAS;
+    odd1 = ((w1 >> 16) & SWAR_MASK) + SWAR_BIAS;
+    // process all "+1" coefficients of the sparse ternary polynomial v(x)
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      w0 = load64(&u[idx]); w1 = load64(&u[idx+4]);
+      even0 += w0 & SWAR_MASK; odd0 += (w0 >> 16) & SWAR_MASK;
+      even1 += w1 & SWAR_MASK; odd1 += (w1 >> 16) & SWAR_MASK;
+      idx += 8;
+      index[j] = idx - (INTMASK(idx >= N) & N);
+    }
+    // process all "-1" coefficients of the sparse ternary polynomial v(x)
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      w0 = load64(&u[idx]); w1 = load64(&u[idx+4]);
+      even0 -= w0 & SWAR_MASK; odd0 -= (w0 >> 16) & SWAR_MASK;
+      even1 -= w1 & SWAR_MASK; odd1 -= (w1 >> 16) & SWAR_MASK;
+      idx += 8;
+      index[j] = idx - (INTMASK(idx >= N) & N);
+    }
+    // merge the lanes and write the eight coefficients back to RAM
+    store64(&r[i], (even0 & SWAR_MASK) | ((odd0 & SWAR_MASK) << 16));
+    store64(&r[i+4], (even1 & SWAR_MASK) | ((odd1 & SWAR_MASK) << 16));
+  }
+}
+
+
+#if defined(__SSE2__) || defined(AVRNTRU_X86_TARGETS)
+
+// The function <ring_mul_tern_sparse_sse2> is a vectorized implementation of
+// the function <ring_mul_tern_sparse_c99> for x86 processors supporting SSE2.
+// The eight coefficient-sums of the hybrid method are kept in the eight 16-bit
+// elements of one 128-bit XMM register, and the eight coefficients of u(x) are
+// fetched through a single unaligned 128-bit load from u[idx]. Consequently,
+// the operands and the result have exactly the same format as in the C99
+// version (the array <u> consists of N+7 elements).
+
+TARGET_SSE2
+void ring_mul_tern_sparse_sse2(uint16_t *r, const uint16_t *u,
+                               const uint16_t *v, int vlen, int N)
+{
+  int index[_vlen], i, j, idx;
+  __m128i sum;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE, index);
+  // compute index = -j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++)
+    index[i] = INTMASK(v[i] != 0) & (N - v[i]);
+
+  for (i = 0; i < N; i += 8) {
+    // load eight coefficients of r(x) into an XMM register
+    sum = _mm_loadu_si128((const __m128i *) &r[i]);
+    // process all "+1" coefficients of the sparse ternary polynomial v(x)
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      sum = _mm_add_epi16(sum, _mm_loadu_si128((const __m128i *) &u[idx]));
+      index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+    }
+    // process all "-1" coefficients of the sparse ternary polynomial v(x)
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      sum = _mm_sub_epi16(sum, _mm_loadu_si128((const __m128i *) &u[idx]));
+      index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+    }
+    // write the (updated) eight coefficients back to RAM
+    _mm_storeu_si128((__m128i *) &r[i], sum);
+  }
+}
+
+#endif  // defined(__SSE2__) || ...
+
+
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+
+// The function <ring_mul_tern_sparse_avx2> is a vectorized implementation of
+// the function <ring_mul_tern_sparse_c99> for x86-64 processors supporting the
+// AVX2 instruction set. It takes the same operands and produces exactly the
+// same result as the C99 version, but computes 16 coefficients of z(x) per
+// iteration of the main loop, which are accumulated in a single 256-bit YMM
+// register. The 16 coefficients of u(x) to be added to (or subtracted from)
+// the coefficient-sums are fetched through two unaligned 128-bit loads, namely
+// from u[idx] and u[idx2], whereby idx2 = idx + 8 mod N. Splitting the loads
+// in this way ensures that no element beyond u[N+6] is ever accessed, i.e. the
+// array <u> still needs to consist of only N+7 elements (N must be >= 16).
+// When the length of the result-array <z> is not a multiple of 16, the last
+// eight coefficients of z(x) are computed with 128-bit SSE2 instructions.
+
+TARGET_AVX2
+void ring_mul_tern_sparse_avx2(uint16_t *r, const uint16_t *u,
+                               const uint16_t *v, int vlen, int N)
+{
+  int index[_vlen], i, j, idx, idx2, len = (N + 7) & (-8);
+  __m256i sum, coef;
+  __m128i sum8, lo, hi;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE, index);
+  // compute index = -j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++)
+    index[i] = INTMASK(v[i] != 0) & (N - v[i]);
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    // load 16 coefficients of r(x) into a YMM register
+    sum = _mm256_loadu_si256((const __m256i *) &r[i]);
+    // process all "+1" coefficients of the sparse ternary polynomial v(x)
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      idx2 = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+      lo = _mm_loadu_si128((const __m128i *) &u[idx]);
+      hi = _mm_loadu_si128((const __m128i *) &u[idx2]);
+      coef = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+      sum = _mm256_add_epi16(sum, coef);
+      index[j] = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+    }
+    // process all "-1" coefficients of the sparse ternary polynomial v(x)
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      idx2 = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+      lo = _mm_loadu_si128((const __m128i *) &u[idx]);
+      hi = _mm_loadu_si128((const __m128i *) &u[idx2]);
+      coef = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+      sum = _mm256_sub_epi16(sum, coef);
+      index[j] = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+    }
+    // write the (updated) 16 coefficients back to RAM
+    _mm256_storeu_si256((__m256i *) &r[i], sum);
+  }
+
+  // the (optional) last eight coefficients are computed with SSE2
+  for (; i < N; i += 8) {
+    sum8 = _mm_loadu_si128((const __m128i *) &r[i]);
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      sum8 = _mm_add_epi16(sum8, _mm_loadu_si128((const __m128i *) &u[idx]));
+      index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+    }
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      sum8 = _mm_sub_epi16(sum8, _mm_loadu_si128((const __m128i *) &u[idx]));
+      index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+    }
+    _mm_storeu_si128((__m128i *) &r[i], sum8);
+  }
+}
+
+
+// The function <ring_mul_tern_sparse_wide_avx2> is identical to the function
+// <ring_mul_tern_sparse_avx2>, except that the array <u> must consist of N+15
+// elements (with u[N+i] = u[i] for 0 <= i < 15), which allows 16 coefficients
+// of u(x) to be fetched through a single 256-bit load from u[idx] instead of
+// two 128-bit loads. Operands of this form are, for example, public keys that
+// have been prepared with the function <ntru_pubkey_init>.
+
+TARGET_AVX2
+void ring_mul_tern_sparse_wide_avx2(uint16_t *r, const uint16_t *u,
+                                    const uint16_t *v, int vlen, int N)
+{
+  int index[_vlen], i, j, idx, len = (N + 7) & (-8);
+  __m256i sum, coef;
+  __m128i sum8;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE, index);
+  // compute index = -j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++)
+    index[i] = INTMASK(v[i] != 0) & (N - v[i]);
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    // load 16 coefficients of r(x) into a YMM register
+    sum = _mm256_loadu_si256((const __m256i *) &r[i]);
+    // process all "+1" coefficients of the sparse ternary polynomial v(x)
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      coef = _mm256_loadu_si256((const __m256i *) &u[idx]);
+      sum = _mm256_add_epi16(sum, coef);
+      index[j] = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+    }
+    // process all "-1" coefficients of the sparse ternary polynomial v(x)
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      coef = _mm256_loadu_si256((const __m256i *) &u[idx]);
+      sum = _mm256_sub_epi16(sum, coef);
+      index[j] = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+    }
+    // write the (updated) 16 coefficients back to RAM
+    _mm256_storeu_si256((__m256i *) &r[i], sum);
+  }
+
+  // the (optional) last eight coefficients are computed with SSE2
+  for (; i < N; i += 8) {
+    sum8 = _mm_loadu_si128((const __m128i *) &r[i]);
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      sum8 = _mm_add_epi16(sum8, _mm_loadu_si128((const __m128i *) &u[idx]));
+      index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+    }
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      sum8 = _mm_sub_epi16(sum8, _mm_loadu_si128((const __m128i *) &u[idx]));
+      index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+    }
+    _mm_storeu_si128((__m128i *) &r[i], sum8);
+  }
+}
+
+#endif  // defined(__AVX2__) || ...
+
+
+#if defined(__AVX512BW__) || defined(AVRNTRU_X86_TARGETS)
+
+// The function <ring_mul_tern_sparse_avx512> is similar to the AVX2 version
+// above, but uses the 512-bit ZMM registers of AVX-512BW to compute 32 coeffs
+// of z(x) per iteration of the main loop. The 32 coefficients of u(x) are now
+// fetched through four unaligned 128-bit loads from u[idx], u[idx+8 mod N],
+// u[idx+16 mod N], and u[idx+24 mod N], whereby these four offsets are all
+// computed directly from idx (and not from each other) to shorten the chain of
+// dependent instructions (N must be >= 32). The remaining eight, 16, or 24
+// coefficients of z(x) (when the length of <z> is not a multiple of 32) are
+// computed with 128-bit SSE2 instructions.
+
+TARGET_AVX512
+void ring_mul_tern_sparse_avx512(uint16_t *r, const uint16_t *u,
+                                 const uint16_t *v, int vlen, int N)
+{
+  int index[_vlen], i, j, idx, idx1, idx2, idx3, len = (N + 7) & (-8);
+  __m512i sum, coef;
+  __m256i lo, hi;
+  __m128i sum8, p0, p1, p2, p3;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE, index);
+  // compute index = -j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++)
+    index[i] = INTMASK(v[i] != 0) & (N - v[i]);
+
+  for (i = 0; i + 32 <= len; i += 32) {
+    // load 32 coefficients of r(x) into a ZMM register
+    sum = _mm512_loadu_si512((const void *) &r[i]);
+    // process all "+1" coefficients of the sparse ternary polynomial v(x)
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      idx1 = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+      idx2 = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+      idx3 = idx + 24 - (INTMASK(idx + 24 >= N) & N);
+      p0 = _mm_loadu_si128((const __m128i *) &u[idx]);
+      p1 = _mm_loadu_si128((const __m128i *) &u[idx1]);
+      p2 = _mm_loadu_si128((const __m128i *) &u[idx2]);
+      p3 = _mm_loadu_si128((const __m128i *) &u[idx3]);
+      lo = _mm256_inserti128_si256(_mm256_castsi128_si256(p0), p1, 1);
+      hi = _mm256_inserti128_si256(_mm256_castsi128_si256(p2), p3, 1);
+      coef = _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+      sum = _mm512_add_epi16(sum, coef);
+      index[j] = idx + 32 - (INTMASK(idx + 32 >= N) & N);
+    }
+    // process all "-1" coefficients of the sparse ternary polynomial v(x)
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      idx1 = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+      idx2 = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+      idx3 = idx + 24 - (INTMASK(idx + 24 >= N) & N);
+      p0 = _mm_loadu_si128((const __m128i *) &u[idx]);
+      p1 = _mm_loadu_si128((const __m128i *) &u[idx1]);
+      p2 = _mm_loadu_si128((const __m128i *) &u[idx2]);
+      p3 = _mm_loadu_si128((const __m128i *) &u[idx3]);
+      lo = _mm256_inserti128_si256(_mm256_castsi128_si256(p0), p1, 1);
+      hi = _mm256_inserti128_si256(_mm256_castsi128_si256(p2), p3, 1);
+      coef = _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+      sum = _mm512_sub_epi16(sum, coef);
+      index[j] = idx + 32 - (INTMASK(idx + 32 >= N) & N);
+    }
+    // write the (updated) 32 coefficients back to RAM
+    _mm512_storeu_si512((void *) &r[i], sum);
+  }
+
+  // the (optional) remaining coefficients are computed with SSE2
+  for (; i < N; i += 8) {
+    sum8 = _mm_loadu_si128((const __m128i *) &r[i]);
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      sum8 = _mm_add_epi16(sum8, _mm_loadu_si128((const __m128i *) &u[idx]));
+      index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+    }
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      sum8 = _mm_sub_epi16(sum8, _mm_loadu_si128((const __m128i *) &u[idx]));
+      index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+    }
+    _mm_storeu_si128((__m128i *) &r[i], sum8);
+  }
+}
+
+#endif  // defined(__AVX512BW__) || ...
+
+
 // The function <ring_mul_tern_prodform> performs a polynomial multiplication
 // r(x) = a(x)*b(x) in the quotient ring R = (Z/Zq)[x]/(x^N-1), where a(x) is
 // an arbitrary element of the ring (i.e. a polynomial of degree up to N-1 with
@@ -154,26 +574,816 @@ void ring_mul_tern_sparse_V2(uint16_t *r, const uint16_t *u, const uint16_t *v,
 // b1(x), b2(x), b3(x), and (ii) three integers specifying the number of non-0
 // coefficients of each sub-polynomial. The coefficients of the product r(x)
 // are written to the first <N> elements of array <r> and are reduced modulo
-// q = 2^11 = 2048. Note that the up to seven remaining elements of array <z>
-// will contain arbitrary values and can be ignored.
+// q = 2^AVRNTRU_LOG_Q (e.g. 2048). Note that the up to seven remaining
+// elements of array <z> will contain arbitrary values and can be ignored. The
+// 2nd and 3rd sparse multiplication are carried out in a single pass by the
+// function <ring_mul_tern_sparse2>, which also performs the reduction modulo
+// q, so that <r> is written only once and does not need to be initialized.
+// The temporary array <t> of N+7 elements can not be avoided (or shared with
+// <r>) since every coefficient of the 2nd product depends on coefficients of
+// a(x)*b1(x) spread over the whole ring. The coefficients of a(x) do not need
+// to be reduced modulo q, and neither are those of t(x), since all results of
+// the 16-bit arithmetic are correct modulo 2^16 and thus modulo q (config.h).
 
 void ring_mul_tern_prodform(uint16_t *r, const uint16_t *a,
                             const prod_form_poly_t *b, int N)
 {
   int i;
   uint16_t t[_tlen], *bstart = b->indices;
+  AVRNTRU_STATS_VAR(start);
+
+  AVRNTRU_STATS_START(start);
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_PRODFORM, t);
+  // Initialization of array <t>
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_ZERO,
+    for (i = ((N+7)&(-8))-1; i >= 0; i--) t[i] = 0);
+  // 1st multiplication: t(x) = a(x)*b1(x)
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE,
+    ring_mul_tern_sparse(t, a, bstart, b->num_nzc_poly1, N));
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_COPY,
+    for (i = 6; i >= 0; i--) t[N+i] = t[i]);
+  // 2nd and 3rd multiplication: r(x) = t(x)*b2(x) + a(x)*b3(x) mod q
+  bstart = &(b->indices[b->num_nzc_poly1]);
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE2,
+    ring_mul_tern_sparse2(r, t, a, bstart, b->num_nzc_poly2, \
+                          b->num_nzc_poly3, N));
+  AVRNTRU_STATS_STOP(AVRNTRU_STAT_PRODFORM, start);
+}
+
 
-  // Initialization of array <r> and <t>
-  for (i = ((N+7)&(-8))-1; i >= 0; i--) r[i] = t[i] = 0;
+// The function <ring_mul_tern_prodform_wide> computes the same product as
+// <ring_mul_tern_prodform>, but the array <a> must consist of N+PAD elements,
+// whereby PAD = AVRNTRU_PUBKEY_PAD and a[N+i] = a[i] for 0 <= i < PAD. It is
+// intended for public keys prepared with <ntru_pubkey_init>, which are padded
+// in this way once per key. The wrap-around elements of the temporary array
+// <t> are set accordingly, so that all three multiplications can use the
+// "wide" versions of the sparse multiplication (see config.h). On AVR and on
+// platforms without AVX2, PAD is 7 and this function is equivalent to the
+// function <ring_mul_tern_prodform>.
+
+void ring_mul_tern_prodform_wide(uint16_t *r, const uint16_t *a,
+                                 const prod_form_poly_t *b, int N)
+{
+  int i;
+  uint16_t t[_wlen], *bstart = b->indices;
+  AVRNTRU_STATS_VAR(start);
+
+  AVRNTRU_STATS_START(start);
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_PRODFORM, t);
+  // Initialization of array <t>
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_ZERO,
+    for (i = ((N+7)&(-8))-1; i >= 0; i--) t[i] = 0);
   // 1st multiplication: t(x) = a(x)*b1(x)
-  ring_mul_tern_sparse(t, a, bstart, b->num_nzc_poly1, N);
-  // 2nd multiplication: r(x) = t(x)*b2(x) = a(x)*b1(x)*b2(x)
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE,
+    ring_mul_tern_sparse_wide(t, a, bstart, b->num_nzc_poly1, N));
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_COPY,
+    for (i = AVRNTRU_PUBKEY_PAD-1; i >= 0; i--) t[N+i] = t[i]);
+  // 2nd and 3rd multiplication: r(x) = t(x)*b2(x) + a(x)*b3(x) mod q
   bstart = &(b->indices[b->num_nzc_poly1]);
-  for (i = 6; i >= 0; i--) t[N+i] = t[i];
-  ring_mul_tern_sparse(r, t, bstart, b->num_nzc_poly2, N);
-  // 3rd multiplication: r(x) = r(x) + a(x)*b3(x) = a(x)*[b1(x)*b2(x) + b3(x)]
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE2,
+    ring_mul_tern_sparse2_wide(r, t, a, bstart, b->num_nzc_poly2, \
+                               b->num_nzc_poly3, N));
+  AVRNTRU_STATS_STOP(AVRNTRU_STAT_PRODFORM, start);
+}
+
+
+// The function <ring_mul_tern_prodform_mod3> computes m(x) = a(x)*f(x) mod 3,
+// where f(x) = 1 + 3*b(x) and b(x) is a product-form polynomial, whereby the
+// coefficients of a(x)*f(x) are centered modulo q = 2^AVRNTRU_LOG_Q before the
+// reduction modulo 3. This is exactly the computation of the NTRU decryption
+// with a(x) being the ciphertext e(x) and b(x) the private key F(x). The
+// operands have the same format as in <ring_mul_tern_prodform>, while the
+// coefficients of the result m(x) are 0, 1, or -1 (i.e. 0xFFFF). The first two
+// multiplications are identical to <ring_mul_tern_prodform>; the third one is
+// performed with the fused function <ring_mul_tern_sparse_mod3>, which also
+// takes care of the scaling by 3, addition of a(x), centering, and reduction
+// modulo 3.
+
+void ring_mul_tern_prodform_mod3(uint16_t *m, const uint16_t *a,
+                                 const prod_form_poly_t *b, int N)
+{
+  int i;
+  uint16_t t[_tlen], *bstart = b->indices;
+  AVRNTRU_STATS_VAR(start);
+
+  AVRNTRU_STATS_START(start);
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_PRODFORM, t);
+  // Initialization of array <m> and <t>
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_ZERO,
+    for (i = ((N+7)&(-8))-1; i >= 0; i--) m[i] = t[i] = 0);
+  // 1st multiplication: t(x) = a(x)*b1(x)
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE,
+    ring_mul_tern_sparse(t, a, bstart, b->num_nzc_poly1, N));
+  // 2nd multiplication: m(x) = t(x)*b2(x) = a(x)*b1(x)*b2(x)
+  bstart = &(b->indices[b->num_nzc_poly1]);
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_COPY,
+    for (i = 6; i >= 0; i--) t[N+i] = t[i]);
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE,
+    ring_mul_tern_sparse(m, t, bstart, b->num_nzc_poly2, N));
+  // 3rd multiplication: m(x) = a(x) + 3*[m(x) + a(x)*b3(x)] mod 3 (centered)
   bstart = &(b->indices[b->num_nzc_poly1 + b->num_nzc_poly2]);
-  ring_mul_tern_sparse(r, a, bstart, b->num_nzc_poly3, N);
-  // Reduction of the coefficients of r(x) modulo 2048
-  for (i = N-1; i >= 0; i--) r[i] &= 0x07FF;
+  AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE_MOD3,
+    ring_mul_tern_sparse_mod3(m, a, bstart, b->num_nzc_poly3, N));
+  AVRNTRU_STATS_STOP(AVRNTRU_STAT_PRODFORM, start);
+}
+
+
+// The function <ring_mul_tern_sparse_multi_c99> computes <num> polynomial
+// products z_k(x) = u_k(x)*v(x) with 0 <= k < num, i.e. it multiplies <num>
+// ring-elements u_k(x) (e.g. public keys) by one and the same sparse ternary
+// polynomial v(x). The operands and results have the same format as in the
+// function <ring_mul_tern_sparse_c99>, except that <z> and <u> are arrays of
+// pointers and v(x) is not given by the indices j of its non-0 coefficients,
+// but by the start-indices N - j mod N (see ring_prep_prodform). Since v(x)
+// is the same for all <num> products, the indices are shared among them and
+// have to be computed only once per block of eight coefficients instead of
+// once per block and product, i.e. the index arithmetic is amortized over the
+// <num> ring-elements. The products are computed tile by tile, whereby a tile
+// consists of AVRNTRU_TILE_LEN coefficients (see config.h). At the beginning
+// of a tile, the indices of all its blocks are written to the "schedule"
+// <sched>, which is then used for all <num> ring-elements. In this way, the
+// sections of u_k(x) accessed by a tile are loaded into the cache once and
+// used for all blocks of the tile before moving on to u_k+1(x), so that the
+// working set does not grow with <num> (without tiling, all <num>*<vlen>
+// streams of u_k(x) are live at the same time and spill from the L1 cache
+// for larger batches). The <num> arrays of <z> are expected to be initialized
+// (e.g. to 0) before calling the function; see <ring_mul_tern_sparse_c99>.
+
+void ring_mul_tern_sparse_multi_c99(uint16_t *r[], const uint16_t *u[],
+                                    const uint16_t *start, int vlen, int num,
+                                    int N)
+{
+  int index[_vlen], i, i0, i1, j, k, idx, len = (N + 7) & (-8);
+  uint16_t sched[_slen], *sj;
+  register uint16_t sum0, sum1, sum2, sum3, sum4, sum5, sum6, sum7;
+  const uint16_t *uk;
+  uint16_t *z;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE_MULTI, sched);
+  // copy the start-indices -j mod N to the local array <index>
+  for (j = 0; j < vlen; j ++) index[j] = start[j];
+
+  for (i0 = 0; i0 < len; i0 += AVRNTRU_TILE_LEN) {
+    i1 = (len - i0 < AVRNTRU_TILE_LEN) ? len : (i0 + AVRNTRU_TILE_LEN);
+    // schedule of the tile: the indices of v(x) for each block of eight
+    for (i = i0, sj = sched; i < i1; i += 8, sj += vlen) {
+      for (j = 0; j < vlen; j ++) {
+        sj[j] = (uint16_t) (idx = index[j]);
+        idx += 8;
+        index[j] = idx - (INTMASK(idx >= N) & N);
+      }
+    }
+    for (k = 0; k < num; k ++) {
+      z = r[k]; uk = u[k];
+      for (i = i0, sj = sched; i < i1; i += 8, sj += vlen) {
+        // hybrid method: load eight coefficients of z_k(x) to eight registers
+        sum0 = z[i  ]; sum1 = z[i+1]; sum2 = z[i+2]; sum3 = z[i+3];
+        sum4 = z[i+4]; sum5 = z[i+5]; sum6 = z[i+6]; sum7 = z[i+7];
+        // process all "+1" coefficients of the sparse ternary polynomial v(x)
+        for (j = 0; j < vlen/2; j ++) {
+          idx = sj[j];
+          sum0 += uk[idx  ]; sum1 += uk[idx+1]; sum2 += uk[idx+2];
+          sum3 += uk[idx+3]; sum4 += uk[idx+4]; sum5 += uk[idx+5];
+          sum6 += uk[idx+6]; sum7 += uk[idx+7];
+        }
+        // process all "-1" coefficients of the sparse ternary polynomial v(x)
+        for (j = vlen/2; j < vlen; j ++) {
+          idx = sj[j];
+          sum0 -= uk[idx  ]; sum1 -= uk[idx+1]; sum2 -= uk[idx+2];
+          sum3 -= uk[idx+3]; sum4 -= uk[idx+4]; sum5 -= uk[idx+5];
+          sum6 -= uk[idx+6]; sum7 -= uk[idx+7];
+        }
+        // hybrid method: write the (updated) eight coefficients back to RAM
+        z[i  ] = sum0; z[i+1] = sum1; z[i+2] = sum2; z[i+3] = sum3;
+        z[i+4] = sum4; z[i+5] = sum5; z[i+6] = sum6; z[i+7] = sum7;
+      }
+    }
+  }
+}
+
+
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+
+// The function <ring_mul_tern_sparse_multi_avx2> is a vectorized version of
+// the function <ring_mul_tern_sparse_multi_c99> for x86-64 processors with
+// AVX2 support. Similar to <ring_mul_tern_sparse_avx2>, it computes 16 coeffs
+// of each product z_k(x) per iteration of the main loop, which requires two
+// unaligned 128-bit loads from u_k[idx] and u_k[idx2] with idx2 = idx + 8 mod
+// N. However, both <idx> and <idx2> are now taken from the schedule of the
+// tile, which is shared by all <num> products, so the inner loops consist of
+// nothing else than loads and 16-bit additions or subtractions. For each block
+// of 16 coefficients, the schedule contains the <vlen> indices <idx> followed
+// by the <vlen> indices <idx2>. AVRNTRU_TILE_LEN must be a multiple of 16, so
+// that only the last tile can end with a block of eight coefficients, which
+// is computed with SSE2.
+
+TARGET_AVX2
+void ring_mul_tern_sparse_multi_avx2(uint16_t *r[], const uint16_t *u[],
+                                     const uint16_t *start, int vlen, int num,
+                                     int N)
+{
+  int index[_vlen], index2[_vlen], i, i0, i1, j, k, idx, len = (N + 7) & (-8);
+  uint16_t sched[_slen], *sj;
+  const uint16_t *uk;
+  __m256i sum, coef;
+  __m128i sum8, lo, hi;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE_MULTI, sched);
+  // copy the start-indices -j mod N to the local array <index> and compute
+  // the corresponding indices (-j mod N) + 8 mod N for the upper eight coeffs
+  for (j = 0; j < vlen; j ++) {
+    index[j] = idx = start[j];
+    index2[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+  }
+
+  for (i0 = 0; i0 < len; i0 += AVRNTRU_TILE_LEN) {
+    i1 = (len - i0 < AVRNTRU_TILE_LEN) ? len : (i0 + AVRNTRU_TILE_LEN);
+    // schedule of the tile: the indices of v(x) for each block of 16 coeffs
+    // (and the optional last block of eight coefficients)
+    for (i = i0, sj = sched; i < i1; i += 16, sj += 2*vlen) {
+      for (j = 0; j < vlen; j ++) {
+        sj[j] = (uint16_t) (idx = index[j]);
+        idx += 16;
+        index[j] = idx - (INTMASK(idx >= N) & N);
+        sj[vlen+j] = (uint16_t) (idx = index2[j]);
+        idx += 16;
+        index2[j] = idx - (INTMASK(idx >= N) & N);
+      }
+    }
+    for (k = 0; k < num; k ++) {
+      uk = u[k];
+      for (i = i0, sj = sched; i + 16 <= i1; i += 16, sj += 2*vlen) {
+        sum = _mm256_loadu_si256((const __m256i *) &r[k][i]);
+        // process all "+1" coefficients of the sparse ternary polynomial v(x)
+        for (j = 0; j < vlen/2; j ++) {
+          lo = _mm_loadu_si128((const __m128i *) &uk[sj[j]]);
+          hi = _mm_loadu_si128((const __m128i *) &uk[sj[vlen+j]]);
+          coef = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+          sum = _mm256_add_epi16(sum, coef);
+        }
+        // process all "-1" coefficients of the sparse ternary polynomial v(x)
+        for (j = vlen/2; j < vlen; j ++) {
+          lo = _mm_loadu_si128((const __m128i *) &uk[sj[j]]);
+          hi = _mm_loadu_si128((const __m128i *) &uk[sj[vlen+j]]);
+          coef = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+          sum = _mm256_sub_epi16(sum, coef);
+        }
+        _mm256_storeu_si256((__m256i *) &r[k][i], sum);
+      }
+      // the (optional) last eight coefficients are computed with SSE2
+      if (i < i1) {
+        sum8 = _mm_loadu_si128((const __m128i *) &r[k][i]);
+        for (j = 0; j < vlen/2; j ++)
+          sum8 = _mm_add_epi16(sum8, \
+                 _mm_loadu_si128((const __m128i *) &uk[sj[j]]));
+        for (j = vlen/2; j < vlen; j ++)
+          sum8 = _mm_sub_epi16(sum8, \
+                 _mm_loadu_si128((const __m128i *) &uk[sj[j]]));
+        _mm_storeu_si128((__m128i *) &r[k][i], sum8);
+      }
+    }
+  }
+}
+
+#endif  // defined(__AVX2__) || ...
+
+
+// The function <ring_prep_prodform> converts a product-form polynomial b(x),
+// given by the indices of the non-0 coefficients of b1(x), b2(x), and b3(x),
+// into a "prepared" product-form polynomial whose array <start> contains the
+// start-indices N - j mod N of the multiplication. The array <start> must
+// have the same length as array <b->indices> (i.e. the total number of non-0
+// coefficients of b1(x), b2(x), b3(x)) and is referenced by the struct <p>.
+
+void ring_prep_prodform(prod_form_prep_t *p, uint16_t *start,
+                        const prod_form_poly_t *b, int N)
+{
+  int i, len = b->num_nzc_poly1 + b->num_nzc_poly2 + b->num_nzc_poly3;
+
+  // compute index = -j mod N for every j for which coefficient b_j != 0
+  for (i = 0; i < len; i ++)
+    start[i] = INTMASK(b->indices[i] != 0) & (N - b->indices[i]);
+  p->start = start;
+  p->num_nzc_poly1 = b->num_nzc_poly1;
+  p->num_nzc_poly2 = b->num_nzc_poly2;
+  p->num_nzc_poly3 = b->num_nzc_poly3;
+  p->dim = N;
+}
+
+
+// The function <ring_mul_tern_prodform_multi> computes <num> products of the
+// form r_k(x) = a_k(x)*b(x) with 0 <= k < num, i.e. it multiplies <num> ring-
+// elements a_k(x) (e.g. the public keys of <num> recipients) by one and the
+// same product-form polynomial b(x) (e.g. a blinding polynomial). The arrays
+// <r> and <a> contain pointers to <num> result-arrays and operand-arrays that
+// have the same format as in <ring_mul_tern_prodform>, while b(x) has to be
+// given in prepared form (see ring_prep_prodform), which also specifies the
+// dimension N of the ring. All three multiplications are performed with the
+// function <ring_mul_tern_sparse_multi> so that the index arithmetic is shared
+// by all ring-elements a_k(x). The ring-elements are processed in groups of
+// up to AVRNTRU_MAX_BATCH, which limits the size of the temporary array <t> to
+// AVRNTRU_MAX_BATCH*(N+7) elements. The coefficients of the products are left
+// unreduced (i.e. they are correct only modulo q, see config.h) since the
+// consumer of the products normally has to pass over them anyway, e.g. to add
+// the message (ring_add_tern), and reduces them on the fly; otherwise the
+// function <ring_red_modq_c99> can be used.
+
+void ring_mul_tern_prodform_multi(uint16_t *r[], const uint16_t *a[],
+                                  const prod_form_prep_t *b, int num)
+{
+  int i, k, k0, cnt, N = b->dim, len = (N + 7) & (-8);
+  int off2 = b->num_nzc_poly1, off3 = off2 + b->num_nzc_poly2;
+  uint16_t t[AVRNTRU_MAX_BATCH*_tlen], *tk[AVRNTRU_MAX_BATCH];
+  const uint16_t *tc[AVRNTRU_MAX_BATCH];
+  AVRNTRU_STATS_VAR(start);
+
+  AVRNTRU_STATS_START(start);
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_PRODFORM, t);
+  for (k0 = 0; k0 < num; k0 += AVRNTRU_MAX_BATCH) {
+    cnt = (num - k0 < AVRNTRU_MAX_BATCH) ? (num - k0) : AVRNTRU_MAX_BATCH;
+    // Initialization of the arrays <r_k> and <t_k>
+    for (k = 0; k < cnt; k ++) {
+      tc[k] = tk[k] = &t[k*(N+7)];
+      AVRNTRU_STATS_CALL(AVRNTRU_STAT_ZERO,
+        for (i = len-1; i >= 0; i--) r[k0+k][i] = tk[k][i] = 0);
+    }
+    // 1st multiplication: t_k(x) = a_k(x)*b1(x) for all k of the group
+    AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE_MULTI,
+      ring_mul_tern_sparse_multi(tk, &a[k0], b->start, b->num_nzc_poly1, \
+                                 cnt, N));
+    // 2nd multiplication: r_k(x) = t_k(x)*b2(x) = a_k(x)*b1(x)*b2(x)
+    for (k = 0; k < cnt; k ++) {
+      AVRNTRU_STATS_CALL(AVRNTRU_STAT_COPY,
+        for (i = 6; i >= 0; i--) tk[k][N+i] = tk[k][i]);
+    }
+    AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE_MULTI,
+      ring_mul_tern_sparse_multi(&r[k0], tc, &(b->start[off2]), \
+                                 b->num_nzc_poly2, cnt, N));
+    // 3rd multiplication: r_k(x) = r_k(x) + a_k(x)*b3(x) for all k of group
+    AVRNTRU_STATS_CALL(AVRNTRU_STAT_SPARSE_MULTI,
+      ring_mul_tern_sparse_multi(&r[k0], &a[k0], &(b->start[off3]), \
+                                 b->num_nzc_poly3, cnt, N));
+  }
+  AVRNTRU_STATS_STOP(AVRNTRU_STAT_PRODFORM, start);
+}
+
+
+// The function <ring_mul_tern_sparse_mod3_c99> is a variant of the function
+// <ring_mul_tern_sparse_c99> specialized for the last multiplication of the
+// NTRU decryption. It computes z(x) = u(x) + 3*[z(x) + u(x)*v(x)] mod q, then
+// centers the coefficients of z(x) modulo q, and reduces them modulo 3, i.e.
+// the result is a ternary polynomial with coefficients 0, 1, or -1 (in
+// the same representation as the output of <ring_red_mod3_c99>). When z(x) is
+// e(x)*F1(x)*F2(x), u(x) is the ciphertext e(x), and v(x) is F3(x), then this
+// gives the decrypted message m(x) = e(x)*f(x) mod 3 with f(x) = 1 + 3*F(x).
+// Fusing these operations with the multiplication saves three passes over the
+// coefficient arrays (reduction mod q, scaling by 3 and addition of e(x), and
+// centering plus reduction mod 3) since each block of eight coefficients is
+// processed right after the coefficient-sums have been computed. The operands
+// have the same format as in <ring_mul_tern_sparse_c99>.
+
+void ring_mul_tern_sparse_mod3_c99(uint16_t *r, const uint16_t *u,
+                                   const uint16_t *v, int vlen, int N)
+{
+  int index[_vlen], i, j, k, idx;
+  register uint16_t sum0, sum1, sum2, sum3, sum4, sum5, sum6, sum7;
+  uint32_t c;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE_MOD3, index);
+  // compute index = -j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++)
+    index[i] = INTMASK(v[i] != 0) & (N - v[i]);
+
+  for (i = 0; i < N; i += 8) {
+    // hybrid method: load eight coefficients of r(x) to eight registers
+    sum0 = r[i  ]; sum1 = r[i+1]; sum2 = r[i+2]; sum3 = r[i+3];
+    sum4 = r[i+4]; sum5 = r[i+5]; sum6 = r[i+6]; sum7 = r[i+7];
+    // process all "+1" coefficients of the sparse ternary polynomial v(x)
+    for (j = 0; j < vlen/2; j ++) {
+      idx = index[j];
+      sum0 += u[idx++]; sum1 += u[idx++]; sum2 += u[idx++]; sum3 += u[idx++];
+      sum4 += u[idx++]; sum5 += u[idx++]; sum6 += u[idx++]; sum7 += u[idx++];
+      index[j] = idx - (INTMASK(idx >= N) & N);
+    }
+    // process all "-1" coefficients of the sparse ternary polynomial v(x)
+    for (j = vlen/2; j < vlen; j ++) {
+      idx = index[j];
+      sum0 -= u[idx++]; sum1 -= u[idx++]; sum2 -= u[idx++]; sum3 -= u[idx++];
+      sum4 -= u[idx++]; sum5 -= u[idx++]; sum6 -= u[idx++]; sum7 -= u[idx++];
+      index[j] = idx - (INTMASK(idx >= N) & N);
+    }
+    // compute u_k + 3*sum_k for the eight coefficients
+    r[i  ] = u[i  ] + 3*sum0; r[i+1] = u[i+1] + 3*sum1;
+    r[i+2] = u[i+2] + 3*sum2; r[i+3] = u[i+3] + 3*sum3;
+    r[i+4] = u[i+4] + 3*sum4; r[i+5] = u[i+5] + 3*sum5;
+    r[i+6] = u[i+6] + 3*sum6; r[i+7] = u[i+7] + 3*sum7;
+    // reduction mod q, centering, and reduction mod 3 (see ring_red_mod3_c99)
+    for (k = i; k < i + 8; k ++) {
+      c = r[k] & AVRNTRU_Q_MASK;
+      c = CENTER_MOD3(c);
+      c -= 3*((c*0xAAABUL) >> 17);
+      r[k] = (uint16_t) (c - (INTMASK(c >> 1) & 3));
+    }
+  }
+}
+
+
+// The function <ring_mul_tern_sparse2_c99> computes the sum of two products
+// z(x) = u(x)*v1(x) + w(x)*v2(x) mod q, where q = 2^AVRNTRU_LOG_Q, u(x) and
+// w(x) are arbitrary ring-elements, and v1(x) and v2(x) are sparse ternary
+// polynomials.
+// Array <v> contains the indices of the "+1" and "-1" coefficients of v1(x)
+// (first <vlen1> elements) followed by those of v2(x) (next <vlen2> elements),
+// i.e. it has the layout of the index-array of a product-form polynomial. The
+// arrays <u> and <w> have the same format as array <u> of the function
+// <ring_mul_tern_sparse_c99>. In contrast to the latter, <z> is not read but
+// only written (i.e. it does not need to be initialized), and the result is
+// reduced modulo q. This function allows one to perform the 2nd and the 3rd
+// multiplication of a product-form multiplication in a single pass over the
+// result-array, see <ring_mul_tern_prodform>. Like above, the computation is
+// done by a template that is also used for the specialized kernels. The
+// template computes only the coefficients z_lo, ..., z_{hi-1}, where <lo> is
+// a multiple of 8 and <hi> is either a multiple of 8 or N; the index for the
+// coefficient v_j then starts at lo - j mod N instead of -j mod N.
+
+static FORCE_INLINE void ring_mul_tern_sparse2_tmpl(uint16_t *r,
+  const uint16_t *u, const uint16_t *w, const uint16_t *v, int vlen1,
+  int vlen2, int lo, int hi, int N)
+{
+  int index[_dlen], i, j, idx, vlen = vlen1 + vlen2;
+  register uint16_t sum0, sum1, sum2, sum3, sum4, sum5, sum6, sum7;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE2, index);
+  // compute index = lo - j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++) {
+    idx = (INTMASK(v[i] != 0) & (N - v[i])) + lo;
+    index[i] = idx - (INTMASK(idx >= N) & N);
+  }
+
+  for (i = lo; i < hi; i += 8) {
+    // hybrid method: the eight coefficient-sums start at 0
+    sum0 = sum1 = sum2 = sum3 = sum4 = sum5 = sum6 = sum7 = 0;
+    // process all "+1" coefficients of the sparse ternary polynomial v1(x)
+    UNROLL_LOOP
+    for (j = 0; j < vlen1/2; j ++) {
+      idx = index[j];
+      sum0 += u[idx++]; sum1 += u[idx++]; sum2 += u[idx++]; sum3 += u[idx++];
+      sum4 += u[idx++]; sum5 += u[idx++]; sum6 += u[idx++]; sum7 += u[idx++];
+      index[j] = idx - (INTMASK(idx >= N) & N);
+    }
+    // process all "-1" coefficients of the sparse ternary polynomial v1(x)
+    UNROLL_LOOP
+    for (j = vlen1/2; j < vlen1; j ++) {
+      idx = index[j];
+      sum0 -= u[idx++]; sum1 -= u[idx++]; sum2 -= u[idx++]; sum3 -= u[idx++];
+      sum4 -= u[idx++]; sum5 -= u[idx++]; sum6 -= u[idx++]; sum7 -= u[idx++];
+      index[j] = idx - (INTMASK(idx >= N) & N);
+    }
+    // process all "+1" coefficients of the sparse ternary polynomial v2(x)
+    UNROLL_LOOP
+    for (j = vlen1; j < vlen1 + vlen2/2; j ++) {
+      idx = index[j];
+      sum0 += w[idx++]; sum1 += w[idx++]; sum2 += w[idx++]; sum3 += w[idx++];
+      sum4 += w[idx++]; sum5 += w[idx++]; sum6 += w[idx++]; sum7 += w[idx++];
+      index[j] = idx - (INTMASK(idx >= N) & N);
+    }
+    // process all "-1" coefficients of the sparse ternary polynomial v2(x)
+    UNROLL_LOOP
+    for (j = vlen1 + vlen2/2; j < vlen; j ++) {
+      idx = index[j];
+      sum0 -= w[idx++]; sum1 -= w[idx++]; sum2 -= w[idx++]; sum3 -= w[idx++];
+      sum4 -= w[idx++]; sum5 -= w[idx++]; sum6 -= w[idx++]; sum7 -= w[idx++];
+      index[j] = idx - (INTMASK(idx >= N) & N);
+    }
+    // hybrid method: write the eight coefficients mod q to RAM
+    r[i  ] = sum0 & AVRNTRU_Q_MASK; r[i+1] = sum1 & AVRNTRU_Q_MASK;
+    r[i+2] = sum2 & AVRNTRU_Q_MASK; r[i+3] = sum3 & AVRNTRU_Q_MASK;
+    r[i+4] = sum4 & AVRNTRU_Q_MASK; r[i+5] = sum5 & AVRNTRU_Q_MASK;
+    r[i+6] = sum6 & AVRNTRU_Q_MASK; r[i+7] = sum7 & AVRNTRU_Q_MASK;
+  }
+}
+
+void ring_mul_tern_sparse2_c99(uint16_t *r, const uint16_t *u,
+                               const uint16_t *w, const uint16_t *v,
+                               int vlen1, int vlen2, int N)
+{
+  ring_mul_tern_sparse2_tmpl(r, u, w, v, vlen1, vlen2, 0, N, N);
+}
+
+
+// The function <ring_mul_tern_sparse2_part_c99> computes the coefficients
+// z_lo, ..., z_{hi-1} of the sum of products of <ring_mul_tern_sparse2_c99>
+// (see the template above for the conditions on <lo> and <hi>). It allows one
+// to distribute the coefficients of a product among several threads, see
+// <ring_mul_tern_prodform_mt>.
+
+void ring_mul_tern_sparse2_part_c99(uint16_t *r, const uint16_t *u,
+                                    const uint16_t *w, const uint16_t *v,
+                                    int vlen1, int vlen2, int lo, int hi,
+                                    int N)
+{
+  ring_mul_tern_sparse2_tmpl(r, u, w, v, vlen1, vlen2, lo, hi, N);
+}
+
+
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+
+// The function <ring_mul_tern_sparse2_part_avx2> is a vectorized
+// implementation of the function <ring_mul_tern_sparse2_part_c99> based on the
+// same technique as the function <ring_mul_tern_sparse_avx2>, i.e. 16
+// coefficient-sums are held in a YMM register and the coefficients of u(x) and
+// w(x) are fetched through two 128-bit loads each (N must be >= 16).
+
+TARGET_AVX2
+void ring_mul_tern_sparse2_part_avx2(uint16_t *r, const uint16_t *u,
+                                     const uint16_t *w, const uint16_t *v,
+                                     int vlen1, int vlen2, int lo, int hi,
+                                     int N)
+{
+  int index[_dlen], i, j, k, idx, idx2, vlen = vlen1 + vlen2;
+  int len = (hi + 7) & (-8), start[3] = { 0, vlen1, vlen1 + vlen2 };
+  const uint16_t *p;
+  __m256i sum, coef, mask = _mm256_set1_epi16((short) AVRNTRU_Q_MASK);
+  __m128i sum8, lo8, hi8;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE2, index);
+  // compute index = lo - j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++) {
+    idx = (INTMASK(v[i] != 0) & (N - v[i])) + lo;
+    index[i] = idx - (INTMASK(idx >= N) & N);
+  }
+
+  for (i = lo; i + 16 <= len; i += 16) {
+    sum = _mm256_setzero_si256();
+    // k = 0: u(x) and v1(x), k = 1: w(x) and v2(x)
+    for (k = 0; k < 2; k ++) {
+      p = (k == 0) ? u : w;
+      // process all "+1" coefficients of v1(x) or v2(x)
+      for (j = start[k]; j < (start[k] + start[k+1])/2; j ++) {
+        idx = index[j];
+        idx2 = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+        lo8 = _mm_loadu_si128((const __m128i *) &p[idx]);
+        hi8 = _mm_loadu_si128((const __m128i *) &p[idx2]);
+        coef = _mm256_inserti128_si256(_mm256_castsi128_si256(lo8), hi8, 1);
+        sum = _mm256_add_epi16(sum, coef);
+        index[j] = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+      }
+      // process all "-1" coefficients of v1(x) or v2(x)
+      for (; j < start[k+1]; j ++) {
+        idx = index[j];
+        idx2 = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+        lo8 = _mm_loadu_si128((const __m128i *) &p[idx]);
+        hi8 = _mm_loadu_si128((const __m128i *) &p[idx2]);
+        coef = _mm256_inserti128_si256(_mm256_castsi128_si256(lo8), hi8, 1);
+        sum = _mm256_sub_epi16(sum, coef);
+        index[j] = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+      }
+    }
+    // write the 16 coefficients reduced modulo q to RAM
+    _mm256_storeu_si256((__m256i *) &r[i], _mm256_and_si256(sum, mask));
+  }
+
+  // the (optional) last eight coefficients are computed with SSE2
+  for (; i < hi; i += 8) {
+    sum8 = _mm_setzero_si128();
+    for (k = 0; k < 2; k ++) {
+      p = (k == 0) ? u : w;
+      for (j = start[k]; j < (start[k] + start[k+1])/2; j ++) {
+        idx = index[j];
+        sum8 = _mm_add_epi16(sum8, _mm_loadu_si128((const __m128i *) &p[idx]));
+        index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+      }
+      for (; j < start[k+1]; j ++) {
+        idx = index[j];
+        sum8 = _mm_sub_epi16(sum8, _mm_loadu_si128((const __m128i *) &p[idx]));
+        index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+      }
+    }
+    sum8 = _mm_and_si128(sum8, _mm256_castsi256_si128(mask));
+    _mm_storeu_si128((__m128i *) &r[i], sum8);
+  }
+}
+
+
+// The function <ring_mul_tern_sparse2_avx2> is the vectorized counterpart of
+// <ring_mul_tern_sparse2_c99>, i.e. it computes all coefficients of the sum
+// of products with <ring_mul_tern_sparse2_part_avx2>.
+
+TARGET_AVX2
+void ring_mul_tern_sparse2_avx2(uint16_t *r, const uint16_t *u,
+                                const uint16_t *w, const uint16_t *v,
+                                int vlen1, int vlen2, int N)
+{
+  ring_mul_tern_sparse2_part_avx2(r, u, w, v, vlen1, vlen2, 0, N, N);
+}
+
+
+// The function <ring_mul_tern_sparse2_wide_avx2> is identical to the function
+// <ring_mul_tern_sparse2_avx2>, except that both <u> and <w> must consist of
+// N+15 elements (with u[N+i] = u[i] and w[N+i] = w[i] for 0 <= i < 15) so that
+// 16 coefficients can be fetched through a single 256-bit load.
+
+TARGET_AVX2
+void ring_mul_tern_sparse2_wide_avx2(uint16_t *r, const uint16_t *u,
+                                     const uint16_t *w, const uint16_t *v,
+                                     int vlen1, int vlen2, int N)
+{
+  int index[_dlen], i, j, k, idx, vlen = vlen1 + vlen2;
+  int len = (N + 7) & (-8), start[3] = { 0, vlen1, vlen1 + vlen2 };
+  const uint16_t *p;
+  __m256i sum, coef, mask = _mm256_set1_epi16((short) AVRNTRU_Q_MASK);
+  __m128i sum8;
+
+  AVRNTRU_STATS_STACK(AVRNTRU_STAT_SPARSE2, index);
+  // compute index = -j mod N for every j for which coefficient v_j != 0
+  for (i = 0; i < vlen; i ++)
+    index[i] = INTMASK(v[i] != 0) & (N - v[i]);
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    sum = _mm256_setzero_si256();
+    // k = 0: u(x) and v1(x), k = 1: w(x) and v2(x)
+    for (k = 0; k < 2; k ++) {
+      p = (k == 0) ? u : w;
+      // process all "+1" coefficients of v1(x) or v2(x)
+      for (j = start[k]; j < (start[k] + start[k+1])/2; j ++) {
+        idx = index[j];
+        coef = _mm256_loadu_si256((const __m256i *) &p[idx]);
+        sum = _mm256_add_epi16(sum, coef);
+        index[j] = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+      }
+      // process all "-1" coefficients of v1(x) or v2(x)
+      for (; j < start[k+1]; j ++) {
+        idx = index[j];
+        coef = _mm256_loadu_si256((const __m256i *) &p[idx]);
+        sum = _mm256_sub_epi16(sum, coef);
+        index[j] = idx + 16 - (INTMASK(idx + 16 >= N) & N);
+      }
+    }
+    // write the 16 coefficients reduced modulo q to RAM
+    _mm256_storeu_si256((__m256i *) &r[i], _mm256_and_si256(sum, mask));
+  }
+
+  // the (optional) last eight coefficients are computed with SSE2
+  for (; i < N; i += 8) {
+    sum8 = _mm_setzero_si128();
+    for (k = 0; k < 2; k ++) {
+      p = (k == 0) ? u : w;
+      for (j = start[k]; j < (start[k] + start[k+1])/2; j ++) {
+        idx = index[j];
+        sum8 = _mm_add_epi16(sum8, _mm_loadu_si128((const __m128i *) &p[idx]));
+        index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+      }
+      for (; j < start[k+1]; j ++) {
+        idx = index[j];
+        sum8 = _mm_sub_epi16(sum8, _mm_loadu_si128((const __m128i *) &p[idx]));
+        index[j] = idx + 8 - (INTMASK(idx + 8 >= N) & N);
+      }
+    }
+    sum8 = _mm_and_si128(sum8, _mm256_castsi256_si128(mask));
+    _mm_storeu_si128((__m128i *) &r[i], sum8);
+  }
+}
+
+#endif  // defined(__AVX2__) || ...
+
+
+#if defined(AVRNTRU_SPECIALIZE)
+
+// The following macros instantiate the templates of ring_mul_tern_sparse_c99
+// and ring_mul_tern_sparse2_c99 with fixed values of N and vlen (resp. vlen1
+// and vlen2), which yields kernels with loops of constant length (that are
+// completely unrolled) and wrap-around checks against a constant N. They are
+// used for the sparse polynomials of EES401EP2, EES443EP1, and EES743EP1. The
+// name of a kernel contains N followed by the number(s) of non-0 coefficients,
+// e.g. ring_mul_tern_sparse_743_30_c99 is for N = 743 and vlen = 30.
+
+#define SPARSE_KERNEL(NN, VL) \
+void ring_mul_tern_sparse_##NN##_##VL##_c99(uint16_t *r, const uint16_t *u, \
+                                            const uint16_t *v) \
+{ \
+  ring_mul_tern_sparse_tmpl(r, u, v, VL, NN); \
+}
+
+#define SPARSE2_KERNEL(NN, VL1, VL2) \
+void ring_mul_tern_sparse2_##NN##_##VL1##_##VL2##_c99(uint16_t *r, \
+  const uint16_t *u, const uint16_t *w, const uint16_t *v) \
+{ \
+  ring_mul_tern_sparse2_tmpl(r, u, w, v, VL1, VL2, 0, NN, NN); \
+}
+
+SPARSE_KERNEL(401, 16)       // EES401EP2: F1, r1
+SPARSE_KERNEL(443, 18)       // EES443EP1: F1, r1
+SPARSE_KERNEL(743, 22)       // EES743EP1: F1, r1
+SPARSE2_KERNEL(401, 16, 12)  // EES401EP2: F2 and F3, r2 and r3
+SPARSE2_KERNEL(443, 16, 10)  // EES443EP1: F2 and F3, r2 and r3
+SPARSE2_KERNEL(743, 22, 30)  // EES743EP1: F2 and F3, r2 and r3
+
+
+// The function <ring_mul_tern_sparse_spec> selects the specialized kernel for
+// the given <vlen> and <N> and falls back to <ring_mul_tern_sparse_c99> when
+// there is no such kernel. It is used as suffix-less ring_mul_tern_sparse when
+// AVRNTRU_SPECIALIZE is defined (see config.h). Note that the selection only
+// depends on public values and not on the indices in array <v>.
+
+void ring_mul_tern_sparse_spec(uint16_t *r, const uint16_t *u,
+                               const uint16_t *v, int vlen, int N)
+{
+  if ((N == 401) && (vlen == 16)) ring_mul_tern_sparse_401_16_c99(r, u, v);
+  else if ((N == 443) && (vlen == 18)) ring_mul_tern_sparse_443_18_c99(r, u, v);
+  else if ((N == 743) && (vlen == 22)) ring_mul_tern_sparse_743_22_c99(r, u, v);
+  else ring_mul_tern_sparse_c99(r, u, v, vlen, N);
+}
+
+
+// The function <ring_mul_tern_sparse2_spec> is the counterpart of the above
+// function for <ring_mul_tern_sparse2_c99>.
+
+void ring_mul_tern_sparse2_spec(uint16_t *r, const uint16_t *u,
+                                const uint16_t *w, const uint16_t *v,
+                                int vlen1, int vlen2, int N)
+{
+  if ((N == 401) && (vlen1 == 16) && (vlen2 == 12))
+    ring_mul_tern_sparse2_401_16_12_c99(r, u, w, v);
+  else if ((N == 443) && (vlen1 == 16) && (vlen2 == 10))
+    ring_mul_tern_sparse2_443_16_10_c99(r, u, w, v);
+  else if ((N == 743) && (vlen1 == 22) && (vlen2 == 30))
+    ring_mul_tern_sparse2_743_22_30_c99(r, u, w, v);
+  else ring_mul_tern_sparse2_c99(r, u, w, v, vlen1, vlen2, N);
+}
+
+#endif  // defined(AVRNTRU_SPECIALIZE)
+
+
+// The function <ring_add_tern_c99> adds a ternary polynomial m(x) to a ring-
+// element r(x) and reduces the coefficients of the sum modulo q, i.e. it
+// computes r(x) = r(x) + m(x) mod q. Both r(x) and m(x) are represented by
+// arrays of 16-bit unsigned integers containing N coefficients, whereby the
+// coefficients of m(x) are expected to be 0, 1, or -1 (i.e. 0xFFFF) and those
+// of r(x) may be unreduced (e.g. a product of ring_mul_tern_prodform_multi).
+// This is the step of the NTRU encryption in which the message representative
+// m(x) is added to the product r(x)*h(x) of blinding polynomial and public
+// key.
+
+void ring_add_tern_c99(uint16_t *r, const uint16_t *m, int N)
+{
+  int i;
+
+  for (i = N-1; i >= 0; i--) r[i] = (r[i] + m[i]) & AVRNTRU_Q_MASK;
+}
+
+
+// The function <ring_red_modq_c99> reduces the coefficients of a ring-element
+// a(x) modulo <q>, which must be a power of two not exceeding 2^16, and writes
+// them to the array <r>. It is meant for the consumer of a "lazy" result of a
+// chain of multiplications (see config.h), whereby <q> may also be a divisor
+// of AVRNTRU_Q (e.g. q = 32 for toy examples). The arrays <r> and <a> consist
+// of N elements and may overlap (i.e. r = a).
+
+void ring_red_modq_c99(uint16_t *r, const uint16_t *a, uint32_t q, int N)
+{
+  int i;
+  uint16_t mask = (uint16_t) (q - 1);
+
+  for (i = N-1; i >= 0; i--) r[i] = a[i] & mask;
+}
+
+
+// The function <ring_mul3_add_c99> computes r(x) = e(x) + 3*r(x) mod q, which
+// is the step of the NTRU decryption that turns the product
+// r(x) = e(x)*F(x) into a(x) = e(x)*f(x) with f(x) = 1 + 3*F(x). Both r(x) and
+// e(x) are represented by arrays of 16-bit unsigned integers of length N.
+
+void ring_mul3_add_c99(uint16_t *r, const uint16_t *e, int N)
+{
+  int i;
+
+  for (i = N-1; i >= 0; i--) r[i] = (e[i] + 3*r[i]) & AVRNTRU_Q_MASK;
+}
+
+
+// The function <ring_red_mod3_c99> centers the coefficients of a ring-element
+// a(x) modulo q (i.e. brings them into the interval [-q/2, q/2-1]) and
+// reduces the centered coefficients modulo 3. The result r(x) is a ternary
+// polynomial whose coefficients are represented as 0, 1, or -1 (i.e. 0xFFFF).
+// Centering requires no comparison since for a coefficient c in [0, q-1] the
+// centered value is c - q if c >= q/2, and -q is congruent to 1 or 2 modulo 3
+// (depending on whether AVRNTRU_LOG_Q is odd or even), which means it suffices
+// to add bit LOG_Q-1 of c (resp. twice this bit) to c before the reduction
+// (see CENTER_MOD3). The reduction modulo 3 is performed in constant time
+// using a multiplication by the "magic constant" 0xAAAB, which yields c/3 for
+// any c in [0, 2^17-1]. The coefficients of a(x) may be unreduced. The
+// arrays <r> and <a> consist of N elements and may overlap (i.e. r = a).
+
+void ring_red_mod3_c99(uint16_t *r, const uint16_t *a, int N)
+{
+  int i;
+  uint32_t c;
+
+  for (i = N-1; i >= 0; i--) {
+    c = a[i] & AVRNTRU_Q_MASK;
+    c = CENTER_MOD3(c);  // c - q mod 3 when c >= q/2
+    c -= 3*((c*0xAAABUL) >> 17);
+    // convert 2 to -1 (i.e. 0xFFFF)
+    r[i] = (uint16_t) (c - (INTMASK(c >> 1) & 3));
+  }
 }
@@ -21,6 +21,7 @@
 #define AVRNTRU_RING_ARITH_H
 
 #include "typedefs.h"
+#include "config.h"
 
 // Struct for a product-form polynomial f(x) = f1(x)*f2(x) + f3(x) where f1(x),
 // f2(x), and f3(x) are sparse ternary polynomials.
@@ -32,11 +33,101 @@ typedef struct prod_form_poly {
   int num_nzc_poly3;  // number of non-0 coefficients in sparse polynomial f3
 } prod_form_poly_t;
 
+// Struct for a "prepared" product-form polynomial, which holds the start-index
+// N - j mod N of the multiplication for the index j of each non-0 coefficient
+// of the three sparse ternary polynomials f1(x), f2(x), f3(x). It is obtained
+// from a prod_form_poly_t via ring_prep_prodform and allows to multiply one
+// product-form polynomial by several ring-elements without re-computing the
+// start-indices each time.
+
+typedef struct prod_form_prep {
+  uint16_t *start;    // array with start-indices of non-0 coeffs in f1, f2, f3
+  int num_nzc_poly1;  // number of non-0 coefficients in sparse polynomial f1
+  int num_nzc_poly2;  // number of non-0 coefficients in sparse polynomial f2
+  int num_nzc_poly3;  // number of non-0 coefficients in sparse polynomial f3
+  int dim;            // dimension N of the ring the start-indices refer to
+} prod_form_prep_t;
+
 // Function prototypes
 
 void ring_mul_tern_sparse_c99(uint16_t *r, const uint16_t *u, const uint16_t *v,
                               int vlen, int N);
+void ring_mul_tern_sparse_V2(uint16_t *r, const uint16_t *u, const uint16_t *v,
+                             int vlen, int N);
+void ring_mul_tern_sparse_swar(uint16_t *r, const uint16_t *u,
+                               const uint16_t *v, int vlen, int N);
 void ring_mul_tern_prodform(uint16_t *r, const uint16_t *a,
                             const prod_form_poly_t *b, int N);
+void ring_mul_tern_prodform_wide(uint16_t *r, const uint16_t *a,
+                                 const prod_form_poly_t *b, int N);
+void ring_mul_tern_sparse_multi_c99(uint16_t *r[], const uint16_t *u[],
+                                    const uint16_t *start, int vlen, int num,
+                                    int N);
+void ring_prep_prodform(prod_form_prep_t *p, uint16_t *start,
+                        const prod_form_poly_t *b, int N);
+void ring_mul_tern_prodform_multi(uint16_t *r[], const uint16_t *a[],
+                                  const prod_form_prep_t *b, int num);
+void ring_mul_tern_sparse_mod3_c99(uint16_t *r, const uint16_t *u,
+                                   const uint16_t *v, int vlen, int N);
+void ring_mul_tern_prodform_mod3(uint16_t *m, const uint16_t *a,
+                                 const prod_form_poly_t *b, int N);
+void ring_mul_tern_sparse2_c99(uint16_t *r, const uint16_t *u,
+                               const uint16_t *w, const uint16_t *v,
+                               int vlen1, int vlen2, int N);
+void ring_mul_tern_sparse2_part_c99(uint16_t *r, const uint16_t *u,
+                                    const uint16_t *w, const uint16_t *v,
+                                    int vlen1, int vlen2, int lo, int hi,
+                                    int N);
+void ring_add_tern_c99(uint16_t *r, const uint16_t *m, int N);
+void ring_mul3_add_c99(uint16_t *r, const uint16_t *e, int N);
+void ring_red_modq_c99(uint16_t *r, const uint16_t *a, uint32_t q, int N);
+void ring_red_mod3_c99(uint16_t *r, const uint16_t *a, int N);
+
+#if defined(AVRNTRU_SPECIALIZE)
+void ring_mul_tern_sparse_401_16_c99(uint16_t *r, const uint16_t *u,
+                                     const uint16_t *v);
+void ring_mul_tern_sparse_443_18_c99(uint16_t *r, const uint16_t *u,
+                                     const uint16_t *v);
+void ring_mul_tern_sparse_743_22_c99(uint16_t *r, const uint16_t *u,
+                                     const uint16_t *v);
+void ring_mul_tern_sparse2_401_16_12_c99(uint16_t *r, const uint16_t *u,
+                                         const uint16_t *w, const uint16_t *v);
+void ring_mul_tern_sparse2_443_16_10_c99(uint16_t *r, const uint16_t *u,
+                                         const uint16_t *w, const uint16_t *v);
+void ring_mul_tern_sparse2_743_22_30_c99(uint16_t *r, const uint16_t *u,
+                                         const uint16_t *w, const uint16_t *v);
+void ring_mul_tern_sparse_spec(uint16_t *r, const uint16_t *u,
+                               const uint16_t *v, int vlen, int N);
+void ring_mul_tern_sparse2_spec(uint16_t *r, const uint16_t *u,
+                                const uint16_t *w, const uint16_t *v,
+                                int vlen1, int vlen2, int N);
+#endif
+#if defined(__SSE2__) || defined(AVRNTRU_X86_TARGETS)
+void ring_mul_tern_sparse_sse2(uint16_t *r, const uint16_t *u,
+                               const uint16_t *v, int vlen, int N);
+#endif
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+void ring_mul_tern_sparse_avx2(uint16_t *r, const uint16_t *u,
+                               const uint16_t *v, int vlen, int N);
+void ring_mul_tern_sparse_wide_avx2(uint16_t *r, const uint16_t *u,
+                                    const uint16_t *v, int vlen, int N);
+void ring_mul_tern_sparse_multi_avx2(uint16_t *r[], const uint16_t *u[],
+                                     const uint16_t *start, int vlen, int num,
+                                     int N);
+void ring_mul_tern_sparse2_avx2(uint16_t *r, const uint16_t *u,
+                                const uint16_t *w, const uint16_t *v,
+                                int vlen1, int vlen2, int N);
+void ring_mul_tern_sparse2_part_avx2(uint16_t *r, const uint16_t *u,
+                                     const uint16_t *w, const uint16_t *v,
+                                     int vlen1, int vlen2, int lo, int hi,
+                                     int N);
+void ring_mul_tern_sparse2_wide_avx2(uint16_t *r, const uint16_t *u,
+                                     const uint16_t *w, const uint16_t *v,
+                                     int vlen1, int vlen2, int N);
+#endif
+#if defined(__AVX512BW__) || defined(AVRNTRU_X86_TARGETS)
+void ring_mul_tern_sparse_avx512(uint16_t *r, const uint16_t *u,
+                                 const uint16_t *v, int vlen, int N);
+#endif
 
 #endif  // AVRNTRU_RING_ARITH_H
@@ -0,0 +1,882 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_arith_bench.c: Cycle and Stack Benchmarks of the Ring Arithmetic.    //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-02-26), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// This program measures the execution time (in clock cycles) and the stack
+// consumption (in bytes) of the C99 and the Assembler versions of the ring
+// arithmetic on AVR for the dimensions of EES401EP2, EES443EP1 and EES743EP1.
+// Every measurement is printed as one line in JSON format, for example:
+// {"kernel":"ring_mul_tern_sparse_avr","N":443,"vlen":18,"cycles":<cycles>,
+// "stack":<bytes>}, which allows one to track the results across releases and
+// to fill in the execution times in the headers of the Assembler files. It is
+// meant to be compiled with avr-gcc and executed in a simulator like simavr,
+// whereby the output of the UART is written to the console:
+//
+// avr-gcc -mmcu=atmega128 -O2 -o bench.elf ring_arith_bench.c ring_arith.c
+//         ring_pack.c utils.c avrasm/*.S
+// simavr -m atmega128 -f 16000000 bench.elf
+//
+// The cycle count is determined with the 16-bit Timer1 (no prescaling) and a
+// counter of timer overflows, which is incremented by an interrupt service
+// routine with a fixed execution time of ISR_CYCLES. The cycles spent in this
+// routine and the overhead of the measurement itself (e.g. the indirect call
+// of the wrapper of the function) are subtracted, i.e. the cycle counts are
+// exact and include the overhead of a direct call of the function. The stack
+// consumption is obtained by "painting" the free RAM with a known pattern and
+// searching for the lowest address that was modified. The product-form
+// multiplications for N = 743 require more than the 4 kB of RAM of the
+// ATmega128 and are only measured on devices with more RAM.
+//
+// On a host processor (e.g. x86), the program measures all C99 and SIMD
+// versions of the sparse multiplication (taken from the kernel registry when
+// AVRNTRU_USE_DISPATCH is defined) and the product-form multiplications with
+// the time-stamp counter. Every function is executed BENCH_WARMUP times before
+// BENCH_RUNS samples are taken on a pinned core. This is repeated in
+// BENCH_ROUNDS rounds, whereby each round measures all functions once (i.e.
+// the rounds of a function are spread over the whole run). The median (named
+// "cycles"), the 10th and 90th percentile of every round are combined through
+// their median over the rounds and printed together with the minimum of all
+// samples and the "rmin", which is the median of the minima of the rounds,
+// converted into clock cycles of the core by means of a calibration loop that
+// is timed right before every round of a function. The output can be stored
+// as baseline, against which a later run is compared to detect slowdowns of
+// more than 3% (or the given tolerance). The comparison uses "rmin" since the
+// minimum is only increased by noise (e.g. interrupts), the median over the
+// rounds filters out disturbed rounds, and the calibration compensates for
+// changes of the clock frequency of the core, which the time-stamp counter
+// does not follow. The functions above the tolerance are measured again in up
+// to BENCH_RETRIES further sets of rounds and only reported when they are
+// still above. The execution times also depend on the placement of the stack
+// and the buffers in memory, which changes from process to process due to
+// address space layout randomization, so both the baseline and the later runs
+// should be started with randomization disabled (setarch -R on Linux):
+//
+// gcc -std=c99 -O2 -mavx2 -o bench ring_arith_bench.c ring_arith.c
+//     ring_dispatch.c utils.c
+// setarch -R ./bench > baseline.json
+// setarch -R ./bench -b baseline.json -t 3
+
+#if !defined(__AVR__) && defined(__linux__)
+#define _GNU_SOURCE  // sched_setaffinity and clock_gettime
+#endif
+
+#include <stdio.h>
+#include "config.h"
+#include "ring_arith.h"
+#include "ring_pack.h"
+#include "utils.h"
+
+#ifdef __AVR__
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static FILE mystdout = FDEV_SETUP_STREAM(uart_putch, NULL, _FDEV_SETUP_WRITE);
+
+
+// Number of cycles of the timer-overflow ISR below, including the interrupt
+// response time of 4 cycles and the jump from the vector table (3 cycles).
+
+#define ISR_CYCLES 31
+
+// Pattern with which the free RAM is painted to determine the stack usage
+#define STACK_PATTERN 0xA5
+
+// Highest dimension for which the product-form multiplications are measured
+#if RAMEND > 0x10FF
+#define BENCH_PF_MAX_DIM 743
+#else
+#define BENCH_PF_MAX_DIM 443
+#endif
+
+volatile uint16_t bench_ovf;  // number of timer overflows
+extern uint8_t __heap_start;  // first byte of free RAM (end of .bss)
+
+
+// Interrupt service routine for the overflow of Timer1, which increments the
+// 16-bit overflow counter. It is written in Assembler to have a fixed number
+// of cycles, namely ISR_CYCLES.
+
+ISR(TIMER1_OVF_vect, ISR_NAKED)
+{
+  __asm__ __volatile__(
+    "push r24                \n\t"
+    "in   r24, __SREG__      \n\t"
+    "push r24                \n\t"
+    "lds  r24, bench_ovf     \n\t"
+    "subi r24, 0xFF          \n\t"
+    "sts  bench_ovf, r24     \n\t"
+    "lds  r24, bench_ovf+1   \n\t"
+    "sbci r24, 0xFF          \n\t"
+    "sts  bench_ovf+1, r24   \n\t"
+    "pop  r24                \n\t"
+    "out  __SREG__, r24      \n\t"
+    "pop  r24                \n\t"
+    "reti                    \n\t");
+}
+
+
+// The function <bench_cycles> executes the function <fn> and returns the
+// number of cycles it took, including the overflow-ISRs (which are subtracted
+// by the caller) and the overhead of starting and stopping the timer.
+
+static uint32_t bench_cycles(void (*fn)(void))
+{
+  uint32_t ovf;
+  uint16_t cnt;
+
+  TCCR1B = 0;
+  TCNT1 = 0;
+  bench_ovf = 0;
+  TIFR = _BV(TOV1);
+  TIMSK |= _BV(TOIE1);
+  sei();
+  TCCR1B = _BV(CS10);  // start Timer1 without prescaling
+  fn();
+  TCCR1B = 0;          // stop Timer1
+  cli();
+  cnt = TCNT1;
+  ovf = bench_ovf;
+  if (TIFR & _BV(TOV1)) {  // overflow after the last ISR
+    TIFR = _BV(TOV1);
+    ovf ++;
+  }
+  TIMSK &= ~_BV(TOIE1);
+
+  return (ovf << 16) + cnt - ovf*ISR_CYCLES;
+}
+
+
+// The function <bench_stack> executes the function <fn> with interrupts being
+// disabled and returns the maximum number of bytes the stack grew, including
+// the return address of <fn>.
+
+static uint16_t __attribute__((noinline)) bench_stack(void (*fn)(void))
+{
+  uint8_t *p, *sp = (uint8_t *) SP;
+
+  cli();
+  for (p = &__heap_start; p < sp; p ++) *p = STACK_PATTERN;
+  fn();
+  for (p = &__heap_start; (p < sp) && (*p == STACK_PATTERN); p ++);
+
+  return (uint16_t) (sp - p);
+}
+
+
+// Operands of the measured functions, which are large enough for N = 743. The
+// arrays <u> and <v> are also used as operands w(x) and v2(x) in the sums of
+// two products to save RAM.
+
+static uint16_t u[743+7], z[744], idx[74];
+static int bench_N, bench_vlen, bench_vlen1, bench_vlen2, bench_vlen3;
+
+
+// Simple linear congruential generator to produce reproducible operands
+
+static uint32_t lcg_state = 1;
+
+static uint16_t lcg_next(void)
+{
+  lcg_state = lcg_state*1103515245UL + 12345UL;
+  return (uint16_t) (lcg_state >> 16);
+}
+
+
+// Wrappers of the measured functions with operands in the global variables.
+// The function <bench_nop> is used to determine the measurement overhead.
+
+static void bench_nop(void)
+{
+}
+
+static void bench_sparse_c99(void)
+{
+  ring_mul_tern_sparse_c99(z, u, idx, bench_vlen, bench_N);
+}
+
+static void bench_sparse2_c99(void)
+{
+  ring_mul_tern_sparse2_c99(z, u, u, idx, bench_vlen2, bench_vlen3, bench_N);
+}
+
+static void bench_sparse_mod3_c99(void)
+{
+  ring_mul_tern_sparse_mod3_c99(z, u, idx, bench_vlen, bench_N);
+}
+
+#if defined(AVRNTRU_USE_ASM)
+
+static void bench_sparse_avr(void)
+{
+  ring_mul_tern_sparse_avr(z, u, idx, bench_vlen, bench_N);
+}
+
+static void bench_sparse2_avr(void)
+{
+  ring_mul_tern_sparse2_avr(z, u, u, idx, bench_vlen2, bench_vlen3, bench_N);
+}
+
+static void bench_sparse_mod3_avr(void)
+{
+  ring_mul_tern_sparse_mod3_avr(z, u, idx, bench_vlen, bench_N);
+}
+
+static void bench_unpack_avr(void)
+{
+  ring_unpack_avr(u, (const uint8_t *) z, bench_N);
+}
+
+#endif  // defined(AVRNTRU_USE_ASM)
+
+// The unpacking reads the bytes of array <z> (whatever their content) and
+// overwrites <u> with a valid operand of N+7 coefficients, so that array <u>
+// can be re-used for the following measurements.
+
+static void bench_unpack_c99(void)
+{
+  ring_unpack_c99(u, (const uint8_t *) z, bench_N);
+}
+
+static void bench_prodform(void)
+{
+  prod_form_poly_t b = { idx, bench_vlen1, bench_vlen2, bench_vlen3 };
+
+  ring_mul_tern_prodform(z, u, &b, bench_N);
+}
+
+static void bench_prodform_mod3(void)
+{
+  prod_form_poly_t b = { idx, bench_vlen1, bench_vlen2, bench_vlen3 };
+
+  ring_mul_tern_prodform_mod3(z, u, &b, bench_N);
+}
+
+
+// List of the measured functions; <vlen> specifies which number of non-0
+// coefficients is printed (0: none, 1: vlen, 2: vlen2 and vlen3, 3: vlen1 to
+// vlen3), and <pf> is 1 for the product-form multiplications.
+
+typedef struct bench_func {
+  const char *name;
+  void (*fn)(void);
+  int vlen;
+  int pf;
+} bench_func_t;
+
+static const bench_func_t bench_funcs[] = {
+  { "ring_mul_tern_sparse_c99", bench_sparse_c99, 1, 0 },
+  { "ring_mul_tern_sparse2_c99", bench_sparse2_c99, 2, 0 },
+  { "ring_mul_tern_sparse_mod3_c99", bench_sparse_mod3_c99, 1, 0 },
+  { "ring_unpack_c99", bench_unpack_c99, 0, 0 },
+#if defined(AVRNTRU_USE_ASM)
+  { "ring_mul_tern_sparse_avr", bench_sparse_avr, 1, 0 },
+  { "ring_mul_tern_sparse2_avr", bench_sparse2_avr, 2, 0 },
+  { "ring_mul_tern_sparse_mod3_avr", bench_sparse_mod3_avr, 1, 0 },
+  { "ring_unpack_avr", bench_unpack_avr, 0, 0 },
+#endif
+  { "ring_mul_tern_prodform", bench_prodform, 3, 1 },
+  { "ring_mul_tern_prodform_mod3", bench_prodform_mod3, 3, 1 }
+};
+
+
+// Measurement of all functions for the three parameter sets. The number of
+// non-0 coefficients of the sparse multiplications corresponds to the largest
+// sparse polynomial of the product-form polynomials (i.e. 16, 18, and 30),
+// while the sums of two products use the sizes of f2(x) and f3(x).
+
+void bench_ring_arith(void)
+{
+  int param[3][5] = { { 401, 16, 16, 16, 12 }, { 443, 18, 18, 16, 10 }, \
+                      { 743, 30, 22, 22, 30 } };
+  int i, k, f, nf = (int) (sizeof(bench_funcs)/sizeof(bench_funcs[0]));
+  uint32_t cyc, cyc0 = bench_cycles(bench_nop);
+  uint16_t stk, stk0 = bench_stack(bench_nop);
+  const bench_func_t *bf;
+
+  for (k = 0; k < 3; k ++) {
+    bench_N = param[k][0];
+    bench_vlen = param[k][1];
+    bench_vlen1 = param[k][2];
+    bench_vlen2 = param[k][3];
+    bench_vlen3 = param[k][4];
+    for (i = 0; i < bench_N + 7; i ++) u[i] = lcg_next() & 0x07FF;
+    for (i = 0; i < 7; i ++) u[bench_N+i] = u[i];
+    for (i = 0; i < 74; i ++) idx[i] = lcg_next() % bench_N;
+    for (f = 0; f < nf; f ++) {
+      bf = &bench_funcs[f];
+      if (bf->pf && (bench_N > BENCH_PF_MAX_DIM)) continue;
+      cyc = bench_cycles(bf->fn) - cyc0;
+      stk = bench_stack(bf->fn) - stk0;
+      printf("{\"kernel\":\"%s\",\"N\":%i,", bf->name, bench_N);
+      if (bf->vlen == 1) printf("\"vlen\":%i,", bench_vlen);
+      if (bf->vlen == 2) printf("\"vlen\":[%i,%i],", bench_vlen2, \
+                                bench_vlen3);
+      if (bf->vlen == 3) printf("\"vlen\":[%i,%i,%i],", bench_vlen1, \
+                                bench_vlen2, bench_vlen3);
+      printf("\"cycles\":%lu,\"stack\":%u}\n", (unsigned long) cyc, \
+             (unsigned) stk);
+    }
+  }
+}
+
+#else  // host processor, e.g. x86
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+#else
+#define BENCH_UNIT "ns"
+#endif
+#include "ring_dispatch.h"
+
+#define BENCH_WARMUP 200    // number of runs before the measurement
+#define BENCH_RUNS 1001     // number of measured runs (samples)
+#define BENCH_MAX_LINES 256 // maximum number of lines of a baseline file
+#define BENCH_MAX_KEY 128   // maximum length of the key of a measurement
+#define BENCH_ROUNDS 9      // number of interleaved rounds of measurements
+#define BENCH_RETRIES 2     // number of re-runs before a slowdown is reported
+#define BENCH_CAL_LEN 1000  // number of iterations of the calibration loop
+#define BENCH_CAL_RUNS 50   // number of runs of the calibration loop
+
+// Type of the measured function, i.e. the sparse multiplication, the sum of
+// two sparse multiplications, or the product-form multiplication
+
+enum { BENCH_SPARSE, BENCH_SPARSE2, BENCH_PRODFORM };
+
+typedef struct bench_func {
+  const char *name;
+  int type;
+  void (*sparse)(uint16_t *r, const uint16_t *u, const uint16_t *v, int vlen,
+                 int N);
+  void (*sparse2)(uint16_t *r, const uint16_t *u, const uint16_t *w,
+                  const uint16_t *v, int vlen1, int vlen2, int N);
+  void (*prodform)(uint16_t *r, const uint16_t *a, const prod_form_poly_t *b,
+                   int N);
+} bench_func_t;
+
+// Functions measured on the host. When the kernel registry is available, the
+// sparse multiplications are taken from there instead (see bench_collect), so
+// that every kernel supported by the processor is covered automatically.
+
+static const bench_func_t bench_funcs[] = {
+#if !defined(AVRNTRU_DISPATCH)
+  { "ring_mul_tern_sparse_c99", BENCH_SPARSE, \
+    ring_mul_tern_sparse_c99, NULL, NULL },
+  { "ring_mul_tern_sparse_V2", BENCH_SPARSE, \
+    ring_mul_tern_sparse_V2, NULL, NULL },
+  { "ring_mul_tern_sparse_swar", BENCH_SPARSE, \
+    ring_mul_tern_sparse_swar, NULL, NULL },
+#if defined(AVRNTRU_SPECIALIZE)
+  { "ring_mul_tern_sparse_spec", BENCH_SPARSE, \
+    ring_mul_tern_sparse_spec, NULL, NULL },
+#endif
+#if defined(__SSE2__)
+  { "ring_mul_tern_sparse_sse2", BENCH_SPARSE, \
+    ring_mul_tern_sparse_sse2, NULL, NULL },
+#endif
+#if defined(__AVX2__)
+  { "ring_mul_tern_sparse_avx2", BENCH_SPARSE, \
+    ring_mul_tern_sparse_avx2, NULL, NULL },
+  { "ring_mul_tern_sparse2_avx2", BENCH_SPARSE2, \
+    NULL, ring_mul_tern_sparse2_avx2, NULL },
+#endif
+#if defined(__AVX512BW__)
+  { "ring_mul_tern_sparse_avx512", BENCH_SPARSE, \
+    ring_mul_tern_sparse_avx512, NULL, NULL },
+#endif
+  { "ring_mul_tern_sparse2_c99", BENCH_SPARSE2, \
+    NULL, ring_mul_tern_sparse2_c99, NULL },
+#endif  // !defined(AVRNTRU_DISPATCH)
+  { "ring_mul_tern_prodform", BENCH_PRODFORM, \
+    NULL, NULL, ring_mul_tern_prodform },
+  { "ring_mul_tern_prodform_wide", BENCH_PRODFORM, \
+    NULL, NULL, ring_mul_tern_prodform_wide },
+  { "ring_mul_tern_prodform_mod3", BENCH_PRODFORM, \
+    NULL, NULL, ring_mul_tern_prodform_mod3 }
+};
+
+// Entry of a baseline file, consisting of the key of a measurement (i.e. the
+// JSON members up to "cycles") and the median of the minima of the rounds.
+
+typedef struct bench_entry {
+  char key[BENCH_MAX_KEY];
+  uint64_t min;
+} bench_entry_t;
+
+// Result of a measurement of the current run, consisting of the measured
+// function and its parameters, the key, the median, 10th and 90th percentile,
+// and minimum of every round, the calibration of every round, the "rmin", and
+// a flag that is set when the function is slower than the baseline.
+
+typedef struct bench_result {
+  const bench_func_t *bf;
+  int N, vlen[3];
+  char key[BENCH_MAX_KEY];
+  uint64_t stat[BENCH_ROUNDS][4];
+  uint64_t cal[BENCH_ROUNDS];
+  uint64_t rmin;
+  int slower;
+} bench_result_t;
+
+static bench_entry_t baseline[BENCH_MAX_LINES];
+static int baseline_len;
+static volatile uint32_t bench_sink;  // result of the calibration loop
+
+
+// The function <bench_time> returns the current value of the time-stamp
+// counter on x86 processors, and the monotonic time in nanoseconds otherwise.
+// On x86, the LFENCE instructions prevent the RDTSC instruction from being
+// executed out of order with respect to the measured code.
+
+static uint64_t bench_time(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  uint64_t t;
+
+  _mm_lfence();
+  t = __rdtsc();
+  _mm_lfence();
+
+  return t;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t) ts.tv_sec*1000000000ULL + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+
+// Comparison function for qsort
+
+static int bench_cmp(const void *a, const void *b)
+{
+  uint64_t x = *((const uint64_t *) a), y = *((const uint64_t *) b);
+
+  return (x > y) - (x < y);
+}
+
+
+// The function <bench_pin> binds the calling thread to the given core to
+// avoid migrations during the measurement. It is only supported on Linux.
+
+static void bench_pin(int cpu)
+{
+#if defined(__linux__)
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    fprintf(stderr, "ring_arith_bench: cannot pin to core %i\n", cpu);
+#else
+  (void) cpu;
+#endif
+}
+
+
+// The function <bench_load> reads a baseline file, i.e. a file with the output
+// of a previous run, and stores the key and "rmin" of every measurement in the
+// array <baseline>. Lines that are not measurements are ignored.
+
+static int bench_load(const char *path)
+{
+  char line[256], *c, *m;
+  size_t len;
+  FILE *f = fopen(path, "r");
+
+  if (f == NULL) return -1;
+  baseline_len = 0;
+  while ((baseline_len < BENCH_MAX_LINES) && fgets(line, sizeof(line), f)) {
+    c = strstr(line, "\"cycles\":");
+    if (c == NULL) continue;
+    m = strstr(c, "\"rmin\":");
+    len = (size_t) (c - line);
+    if ((m == NULL) || (len >= BENCH_MAX_KEY)) continue;
+    memcpy(baseline[baseline_len].key, line, len);
+    baseline[baseline_len].key[len] = '\0';
+    baseline[baseline_len].min = strtoull(m + 7, NULL, 10);
+    baseline_len ++;
+  }
+  fclose(f);
+
+  return baseline_len;
+}
+
+
+// The function <bench_base> returns the "rmin" of the measurement with the key
+// <key> in the baseline, or 0 if the measurement is not in the baseline.
+
+static uint64_t bench_base(const char *key)
+{
+  int i;
+
+  for (i = 0; i < baseline_len; i ++) {
+    if (strcmp(baseline[i].key, key) == 0) return baseline[i].min;
+  }
+
+  return 0;
+}
+
+
+// The function <bench_run> measures the function <bf> BENCH_RUNS times (after
+// BENCH_WARMUP runs) for the dimension <N> and the non-0 coefficients given by
+// <vlen>, and stores the sorted samples in the array <t>. The operands are
+// random, whereby the execution time does not depend on them anyway.
+
+static void bench_run(const bench_func_t *bf, int N, const int vlen[3],
+                      uint64_t *t)
+{
+  static uint16_t u[743+AVRNTRU_PUBKEY_PAD], w[743+AVRNTRU_PUBKEY_PAD];
+  static uint16_t z[752], idx[74];
+  prod_form_poly_t b = { idx, vlen[0], vlen[1], vlen[2] };
+  uint64_t t0;
+  int i, k;
+
+  srand(N);
+  for (i = 0; i < N; i ++) u[i] = rand() & 0x07FF;
+  for (i = 0; i < AVRNTRU_PUBKEY_PAD; i ++) u[N+i] = u[i];
+  memcpy(w, u, sizeof(u));
+  for (i = 0; i < 74; i ++) idx[i] = rand() % N;
+  memset(z, 0, sizeof(z));
+
+  for (k = -BENCH_WARMUP; k < BENCH_RUNS; k ++) {
+    t0 = bench_time();
+    switch (bf->type) {
+      case BENCH_SPARSE:
+        bf->sparse(z, u, idx, vlen[0], N);
+        break;
+      case BENCH_SPARSE2:
+        bf->sparse2(z, u, w, idx, vlen[1], vlen[2], N);
+        break;
+      default:
+        bf->prodform(z, u, &b, N);
+    }
+    if (k >= 0) t[k] = bench_time() - t0;
+  }
+  qsort(t, BENCH_RUNS, sizeof(t[0]), bench_cmp);
+}
+
+
+// The function <bench_cal> returns the minimum execution time of
+// BENCH_CAL_RUNS runs of a loop of BENCH_CAL_LEN iterations, each of which
+// depends on the previous one through a single addition, i.e. it takes one
+// clock cycle of the core (the loop counter is updated in parallel). The ratio
+// between the time of the loop and BENCH_CAL_LEN converts a time into clock
+// cycles.
+
+static uint64_t bench_cal(void)
+{
+  uint64_t t0, t, min = (uint64_t) -1;
+  uint32_t x = 0;
+  int i, k;
+
+  for (k = 0; k < BENCH_CAL_RUNS; k ++) {
+    t0 = bench_time();
+    for (i = 0; i < BENCH_CAL_LEN; i ++) {
+      x += 1;
+#if defined(__GNUC__)
+      __asm__ volatile ("" : "+r" (x));  // prevents the folding of the loop
+#endif
+    }
+    t = bench_time() - t0;
+    if (t < min) min = t;
+  }
+  bench_sink = x;
+
+  return min;
+}
+
+
+// The function <bench_rmin> returns the median of the minima of the rounds of
+// the measurement <res>, whereby each minimum is converted into clock cycles
+// with the calibration of its round.
+
+static uint64_t bench_rmin(const bench_result_t *res)
+{
+  uint64_t x[BENCH_ROUNDS];
+  int r;
+
+  for (r = 0; r < BENCH_ROUNDS; r ++)
+    x[r] = (res->stat[r][3]*BENCH_CAL_LEN + res->cal[r]/2)/res->cal[r];
+  qsort(x, BENCH_ROUNDS, sizeof(x[0]), bench_cmp);
+
+  return x[BENCH_ROUNDS/2];
+}
+
+
+// The function <bench_median> returns the median of the values of round 0 to
+// BENCH_ROUNDS-1 of the quantity <q> (0: median, 1: 10th percentile, 2: 90th
+// percentile, 3: minimum) of the result <res>.
+
+static uint64_t bench_median(const bench_result_t *res, int q)
+{
+  uint64_t x[BENCH_ROUNDS];
+  int r;
+
+  for (r = 0; r < BENCH_ROUNDS; r ++) x[r] = res->stat[r][q];
+  qsort(x, BENCH_ROUNDS, sizeof(x[0]), bench_cmp);
+
+  return x[BENCH_ROUNDS/2];
+}
+
+
+// The function <bench_func> performs round <r> of the measurement <res> (see
+// <bench_run>) and stores the median, the 10th and 90th percentile, and the
+// minimum of the samples, as well as the calibration of the round.
+
+static void bench_func(bench_result_t *res, int r)
+{
+  static uint64_t t[BENCH_RUNS];
+
+  res->cal[r] = bench_cal();
+  bench_run(res->bf, res->N, res->vlen, t);
+  res->stat[r][0] = t[BENCH_RUNS/2];
+  res->stat[r][1] = t[BENCH_RUNS/10];
+  res->stat[r][2] = t[BENCH_RUNS - 1 - BENCH_RUNS/10];
+  res->stat[r][3] = t[0];
+}
+
+
+// The function <bench_print> prints the measurement <res> in JSON format, i.e.
+// the key, the median over the rounds of the median, 10th and 90th percentile,
+// the minimum of all rounds, and the "rmin" (in clock cycles).
+
+static void bench_print(const bench_result_t *res)
+{
+  uint64_t min = res->stat[0][3];
+  int r;
+
+  for (r = 1; r < BENCH_ROUNDS; r ++)
+    if (res->stat[r][3] < min) min = res->stat[r][3];
+  printf("%s\"cycles\":%llu,\"p10\":%llu,\"p90\":%llu,\"min\":%llu," \
+         "\"rmin\":%llu,\"unit\":\"%s\"}\n", res->key, \
+         (unsigned long long) bench_median(res, 0), \
+         (unsigned long long) bench_median(res, 1), \
+         (unsigned long long) bench_median(res, 2), \
+         (unsigned long long) min, (unsigned long long) res->rmin, BENCH_UNIT);
+  fflush(stdout);
+}
+
+
+// The function <bench_init> initializes the measurement <res> of the function
+// <bf> for the dimension <N> and the non-0 coefficients given by <vlen>, i.e.
+// it sets the parameters and the key, which consists of the JSON members up
+// to "cycles".
+
+static void bench_init(bench_result_t *res, const bench_func_t *bf, int N,
+                       const int vlen[3])
+{
+  res->bf = bf;
+  res->N = N;
+  memcpy(res->vlen, vlen, sizeof(res->vlen));
+  res->slower = 0;
+  if (bf->type == BENCH_SPARSE)
+    snprintf(res->key, BENCH_MAX_KEY, "{\"kernel\":\"%s\",\"N\":%i," \
+             "\"vlen\":%i,", bf->name, N, vlen[0]);
+  else if (bf->type == BENCH_SPARSE2)
+    snprintf(res->key, BENCH_MAX_KEY, "{\"kernel\":\"%s\",\"N\":%i," \
+             "\"vlen\":[%i,%i],", bf->name, N, vlen[1], vlen[2]);
+  else
+    snprintf(res->key, BENCH_MAX_KEY, "{\"kernel\":\"%s\",\"N\":%i," \
+             "\"vlen\":[%i,%i,%i],", bf->name, N, vlen[0], vlen[1], vlen[2]);
+}
+
+
+// The function <bench_compare> compares the "rmin" of the <num> measurements
+// in <res> with the baseline and returns the number of functions that are more
+// than <tol> percent slower. The functions above the tolerance are measured
+// again in up to BENCH_RETRIES sets of BENCH_ROUNDS interleaved rounds,
+// whereby the lowest "rmin" is kept, before they are reported.
+
+static int bench_compare(bench_result_t *res, int num, double tol)
+{
+  uint64_t base, rmin;
+  char *key;
+  int i, k, r, slower;
+
+  for (k = 0; ; k ++) {
+    for (i = slower = 0; i < num; i ++) {
+      base = bench_base(res[i].key);
+      res[i].slower = (base > 0) && (res[i].rmin > base*(1.0 + tol/100.0));
+      slower += res[i].slower;
+    }
+    if ((slower == 0) || (k == BENCH_RETRIES)) break;
+    for (r = 0; r < BENCH_ROUNDS; r ++) {
+      for (i = 0; i < num; i ++) if (res[i].slower) bench_func(&res[i], r);
+    }
+    for (i = 0; i < num; i ++) {
+      rmin = bench_rmin(&res[i]);
+      if (res[i].slower && (rmin < res[i].rmin)) res[i].rmin = rmin;
+    }
+  }
+  for (i = 0; i < num; i ++) {
+    if (!res[i].slower) continue;
+    base = bench_base(res[i].key);
+    key = res[i].key;
+    key[strlen(key) - 1] = '}';  // replace the trailing comma of the key
+    fprintf(stderr, "REGRESSION: %s rmin %llu vs. %llu (%+.1f%%)\n", key, \
+            (unsigned long long) res[i].rmin, (unsigned long long) base, \
+            100.0*((double) res[i].rmin/base - 1.0));
+  }
+
+  return slower;
+}
+
+
+// The function <bench_collect> copies the functions to be measured into the
+// array <bf> and returns their number. With the kernel registry, it adds the
+// sparse multiplications of all kernels the processor supports, whereby the
+// sums of two sparse multiplications are only added once per function.
+
+static int bench_collect(bench_func_t *bf, char names[][BENCH_MAX_KEY])
+{
+  int i, n = 0, nf = (int) (sizeof(bench_funcs)/sizeof(bench_funcs[0]));
+#if defined(AVRNTRU_DISPATCH)
+  const ring_kernel_t *kern;
+  int j, dup;
+
+  for (i = 0; i < ring_kernel_num(); i ++) {
+    kern = ring_kernel_get(i);
+    if (!kern->supported()) continue;
+    snprintf(names[n], BENCH_MAX_KEY, "ring_mul_tern_sparse_%s", kern->name);
+    bf[n].name = names[n]; bf[n].type = BENCH_SPARSE;
+    bf[n].sparse = kern->sparse; bf[n].sparse2 = NULL; bf[n].prodform = NULL;
+    n ++;
+    for (j = dup = 0; j < n; j ++) dup |= (bf[j].sparse2 == kern->sparse2);
+    if (dup) continue;
+    snprintf(names[n], BENCH_MAX_KEY, "ring_mul_tern_sparse2_%s", kern->name);
+    bf[n].name = names[n]; bf[n].type = BENCH_SPARSE2;
+    bf[n].sparse = NULL; bf[n].sparse2 = kern->sparse2; bf[n].prodform = NULL;
+    n ++;
+  }
+#else
+  (void) names;
+#endif
+  for (i = 0; i < nf; i ++) bf[n++] = bench_funcs[i];
+
+  return n;
+}
+
+
+// Measurement of all functions for the standard parameter sets. The sparse
+// multiplications are measured for every distinct number of non-0 coefficients
+// of the three sparse polynomials of the parameter set, the sums of two sparse
+// multiplications for f2(x) and f3(x), and the product-form multiplications
+// for f(x) = f1(x)*f2(x) + f3(x), in BENCH_ROUNDS interleaved rounds. The
+// return value is the number of functions that are more than <tol> percent
+// slower than the baseline.
+
+int bench_ring_arith(double tol)
+{
+  static const int param[3][4] = { { 401, 16, 16, 12 }, \
+                                   { 443, 18, 16, 10 }, \
+                                   { 743, 22, 22, 30 } };
+  static bench_result_t res[BENCH_MAX_LINES];
+  bench_func_t bf[32];
+  char names[32][BENCH_MAX_KEY];
+  int i, j, k, f, r, nf = bench_collect(bf, names), num = 0;
+  int vlen[3];
+
+  for (k = 0; k < 3; k ++) {
+    for (f = 0; f < nf; f ++) {
+      if (bf[f].type != BENCH_SPARSE) {
+        vlen[0] = param[k][1]; vlen[1] = param[k][2]; vlen[2] = param[k][3];
+        bench_init(&res[num++], &bf[f], param[k][0], vlen);
+        continue;
+      }
+      for (i = 1; i < 4; i ++) {
+        for (j = 1; (j < i) && (param[k][j] != param[k][i]); j ++);
+        if (j < i) continue;  // vlen was already measured
+        vlen[0] = param[k][i];
+        vlen[1] = vlen[2] = 0;
+        bench_init(&res[num++], &bf[f], param[k][0], vlen);
+      }
+    }
+  }
+  for (r = 0; r < BENCH_ROUNDS; r ++) {
+    for (i = 0; i < num; i ++) bench_func(&res[i], r);
+  }
+  for (i = 0; i < num; i ++) {
+    res[i].rmin = bench_rmin(&res[i]);
+    bench_print(&res[i]);
+  }
+
+  return bench_compare(res, num, tol);
+}
+
+#endif  // __AVR__
+
+
+// Without arguments, the benchmark prints its results in JSON format, one line
+// per measurement, so that the output can be stored as baseline. On the host,
+// the option -b <file> compares the "rmin" with a baseline and reports all
+// measurements that are more than 3 percent (or -t <percent>) slower, in which
+// case the exit status is 1. The option -c <core> pins the benchmark to the
+// given core (default: 0).
+
+#ifdef __AVR__
+int main(void)
+{
+  init_uart();
+  stdout = &mystdout;
+  bench_ring_arith();
+
+  return 0;
+}
+#else
+int main(int argc, char *argv[])
+{
+  int i, cpu = 0, slower;
+  double tol = 3.0;
+
+  for (i = 1; i < argc - 1; i += 2) {
+    if (strcmp(argv[i], "-b") == 0) {
+      if (bench_load(argv[i+1]) < 0) {
+        fprintf(stderr, "ring_arith_bench: cannot read %s\n", argv[i+1]);
+        return 2;
+      }
+    } else if (strcmp(argv[i], "-t") == 0) {
+      tol = atof(argv[i+1]);
+    } else if (strcmp(argv[i], "-c") == 0) {
+      cpu = atoi(argv[i+1]);
+    } else break;
+  }
+  if (i < argc) {
+    fprintf(stderr, "usage: %s [-b baseline] [-t percent] [-c core]\n", \
+            argv[0]);
+    return 2;
+  }
+  bench_pin(cpu);
+  slower = bench_ring_arith(tol);
+  if (slower > 0)
+    fprintf(stderr, "ring_arith_bench: %i regression(s) > %.1f%%\n", slower, \
+            tol);
+
+  return (slower > 0);
+}
+#endif
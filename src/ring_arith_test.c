@@ -22,6 +22,10 @@
 #include "config.h"
 #include "ring_arith.h"
 #include "ring_arith_test.h"
+#include "ring_pack.h"
+#include "ring_tern.h"
+#include "ring_mt.h"
+#include "ring_dispatch.h"
 #include "utils.h"
 
 
@@ -53,7 +57,8 @@ void test_ring_mul_11(void)
 
   for (i = 0; i < N; i ++) r[i] = 0;
   ring_mul_tern_sparse(r, a, b, 6, 11);
-  for (i = 0; i < N; i ++) r[i] = (r[i] + c[i]) & 0x1F;
+  for (i = 0; i < N; i ++) r[i] += c[i];
+  ring_red_modq(r, r, 32, N);  // q = 32 in this example
 
   printf("r = { ");
   for (i = 0; i < N-1; i ++) printf("%i, ", r[i]);
@@ -88,6 +93,531 @@ void test_ring_mul_401(void)
 }
 
 
+// Simple linear congruential generator to produce reproducible test operands
+
+static uint32_t lcg_state = 1;
+
+static uint16_t lcg_next(void)
+{
+  lcg_state = lcg_state*1103515245UL + 12345UL;
+  return (uint16_t) (lcg_state >> 16);
+}
+
+
+// Random ring-element with N+7 coefficients in [0, q-1] (incl. wrap-around)
+
+static void rand_ring_elem(uint16_t *u, int N)
+{
+  int i;
+
+  for (i = 0; i < N; i ++) u[i] = lcg_next() & AVRNTRU_Q_MASK;
+  for (i = 0; i < 7; i ++) u[N+i] = u[i];
+}
+
+
+// Random sparse ternary polynomial with <vlen> distinct indices, whereby the
+// first index is 0 so that the wrap-around of the indices is always covered.
+
+static void rand_sparse_poly(uint16_t *v, int vlen, int N)
+{
+  int i, j;
+
+  v[0] = 0;
+  for (i = 1; i < vlen; i ++) {
+    do {  // indices must be distinct
+      v[i] = lcg_next() % N;
+      for (j = 0; (j < i) && (v[j] != v[i]); j ++);
+    } while (j < i);
+  }
+}
+
+
+// Random ternary polynomial in dense representation (coefficients 0, 1, and
+// -1, i.e. 0xFFFF)
+
+static void rand_tern_poly(uint16_t *a, int N)
+{
+  int i;
+
+  for (i = 0; i < N; i ++) {
+    a[i] = lcg_next() % 3;
+    if (a[i] == 2) a[i] = 0xFFFF;
+  }
+}
+
+
+// The following tests compare the active versions of the ring arithmetic
+// (e.g. Assembler on AVR, AVX2 on x86) with the C99 versions and are executed
+// on all platforms. On AVR, they are restricted to N = 401 so that their
+// operands fit into the RAM of the device; TEST_DIMS is the list of the
+// tested dimensions of the three parameter sets.
+
+#ifdef __AVR__
+#define TEST_MAX_DIM 401
+#define TEST_DIMS "401"
+#else
+#define TEST_MAX_DIM 743
+#define TEST_DIMS "401,443,743"
+#endif
+
+
+// Comparison of the (possibly vectorized) ring_mul_tern_sparse against the
+// C99 reference implementation for the dimensions of EES401EP2, EES443EP1, and
+// EES743EP1. The operand u(x) has random coefficients in [0, 2047] and v(x) is
+// a random sparse ternary polynomial whose first "+1" coefficient is v_0 so
+// that the wrap-around of the indices is also covered.
+
+void test_ring_mul_sparse_cmp(void)
+{
+  int dims[3] = { 401, 443, 743 }, vlens[3] = { 16, 18, 30 };
+  int i, k, N, vlen, err;
+  uint16_t u[TEST_MAX_DIM+7], v[AVRNTRU_MAX_NZC];
+  uint16_t z1[TEST_MAX_DIM+7], z2[TEST_MAX_DIM+7];
+
+  for (k = 0; (k < 3) && (dims[k] <= TEST_MAX_DIM); k ++) {
+    N = dims[k]; vlen = vlens[k];
+    rand_ring_elem(u, N);
+    rand_sparse_poly(v, vlen, N);
+    for (i = 0; i < ((N+7)&(-8)); i ++) z1[i] = z2[i] = 0;
+    ring_mul_tern_sparse_c99(z1, u, v, vlen, N);
+    ring_mul_tern_sparse(z2, u, v, vlen, N);
+    for (i = err = 0; i < N; i ++) err |= (z1[i] != z2[i]);
+    printf("ring_mul_tern_sparse (N=%i, vlen=%i): %s\n", N, vlen, \
+           err ? "FAILED" : "OK");
+  }
+}
+
+
+
+// Comparison of the fused function ring_mul_tern_prodform_mod3 against the
+// sequence ring_mul_tern_prodform, ring_mul3_add_c99, and ring_red_mod3_c99,
+// i.e. the three separate passes of the NTRU decryption. The active version
+// of ring_red_mod3 is compared with ring_red_mod3_c99 as well.
+
+void test_ring_mul_mod3_cmp(void)
+{
+  int i, k, N, err = 0;
+  int param[3][4] = { { 401, 16, 16, 12 }, { 443, 18, 16, 10 }, \
+                      { 743, 22, 22, 30 } };
+  uint16_t e[TEST_MAX_DIM+7], fidx[74];
+  uint16_t m1[TEST_MAX_DIM+7], m2[TEST_MAX_DIM+7];
+  prod_form_poly_t F;
+
+  for (k = 0; (k < 3) && (param[k][0] <= TEST_MAX_DIM); k ++) {
+    N = param[k][0];
+    F.indices = fidx;
+    F.num_nzc_poly1 = param[k][1];
+    F.num_nzc_poly2 = param[k][2];
+    F.num_nzc_poly3 = param[k][3];
+    rand_ring_elem(e, N);
+    rand_sparse_poly(&fidx[0], param[k][1], N);
+    rand_sparse_poly(&fidx[param[k][1]], param[k][2], N);
+    rand_sparse_poly(&fidx[param[k][1]+param[k][2]], param[k][3], N);
+    ring_mul_tern_prodform(m1, e, &F, N);
+    ring_mul3_add_c99(m1, e, N);
+    for (i = 0; i < N; i ++) m2[i] = m1[i];
+    ring_red_mod3_c99(m1, m1, N);
+    ring_red_mod3(m2, m2, N);
+    for (i = 0; i < N; i ++) err |= (m1[i] != m2[i]);
+    ring_mul_tern_prodform_mod3(m2, e, &F, N);
+    for (i = 0; i < N; i ++) err |= (m1[i] != m2[i]);
+  }
+  printf("ring_mul_tern_prodform_mod3 (N=" TEST_DIMS "): %s\n", \
+         err ? "FAILED" : "OK");
+}
+
+
+
+// Packing and unpacking of ring-elements with unreduced coefficients for the
+// dimension 11 and the dimensions of the parameter sets, whereby the active
+// version of ring_unpack (e.g. Assembler or AVX2) is compared with the C99
+// version.
+
+void test_ring_pack(void)
+{
+  int i, k, N, err = 0, dims[4] = { 11, 401, 443, 743 };
+  uint16_t a[TEST_MAX_DIM+7], b[TEST_MAX_DIM+7];
+  uint8_t packed[RING_PACKED_LEN(TEST_MAX_DIM)+1];
+
+  for (k = 0; (k < 4) && (dims[k] <= TEST_MAX_DIM); k ++) {
+    N = dims[k];
+    for (i = 0; i < N; i ++) a[i] = lcg_next();
+    packed[RING_PACKED_LEN(N)] = 0xA5;  // must not be overwritten
+    ring_pack(packed, a, N);
+    err |= (packed[RING_PACKED_LEN(N)] != 0xA5);
+    ring_unpack_c99(b, packed, N);
+    for (i = 0; i < N; i ++) err |= (b[i] != (a[i] & AVRNTRU_Q_MASK));
+    for (i = 0; i < 7; i ++) err |= (b[N+i] != b[i]);
+    ring_unpack(a, packed, N);
+    for (i = 0; i < N+7; i ++) err |= (a[i] != b[i]);
+  }
+  printf("ring_pack/ring_unpack (N=11," TEST_DIMS "): %s\n", \
+         err ? "FAILED" : "OK");
+}
+
+
+
+// Compare ring_mul_tern_prodform, which performs the 2nd and 3rd
+// multiplication in a single pass, with the three-pass computation using the
+// C99 functions. Afterwards, a random ternary polynomial (e.g. a message) is
+// added to the product with the active version of ring_add_tern and with the
+// C99 version.
+
+void test_ring_mul_prodform_cmp(void)
+{
+  int i, k, N, err = 0;
+  int param[3][4] = { { 401, 16, 16, 12 }, { 443, 18, 16, 10 }, \
+                      { 743, 22, 22, 30 } };
+  uint16_t a[TEST_MAX_DIM+AVRNTRU_PUBKEY_PAD], t[TEST_MAX_DIM+7], idx[74];
+  uint16_t r1[TEST_MAX_DIM+7], r2[TEST_MAX_DIM+7];
+  prod_form_poly_t b;
+
+  for (k = 0; (k < 3) && (param[k][0] <= TEST_MAX_DIM); k ++) {
+    N = param[k][0];
+    b.indices = idx;
+    b.num_nzc_poly1 = param[k][1];
+    b.num_nzc_poly2 = param[k][2];
+    b.num_nzc_poly3 = param[k][3];
+    rand_ring_elem(a, N);
+    for (i = 7; i < AVRNTRU_PUBKEY_PAD; i ++) a[N+i] = a[i];
+    rand_sparse_poly(&idx[0], param[k][1], N);
+    rand_sparse_poly(&idx[param[k][1]], param[k][2], N);
+    rand_sparse_poly(&idx[param[k][1]+param[k][2]], param[k][3], N);
+    for (i = 0; i < ((N+7)&(-8)); i ++) r1[i] = t[i] = 0;
+    ring_mul_tern_sparse_c99(t, a, &idx[0], param[k][1], N);
+    for (i = 0; i < 7; i ++) t[N+i] = t[i];
+    ring_mul_tern_sparse_c99(r1, t, &idx[param[k][1]], param[k][2], N);
+    ring_mul_tern_sparse_c99(r1, a, &idx[param[k][1]+param[k][2]], \
+                             param[k][3], N);
+    ring_red_modq(r1, r1, AVRNTRU_Q, N);
+    ring_mul_tern_prodform(r2, a, &b, N);
+    for (i = 0; i < N; i ++) err |= (r1[i] != r2[i]);
+    ring_mul_tern_prodform_wide(r2, a, &b, N);
+    for (i = 0; i < N; i ++) err |= (r1[i] != r2[i]);
+    rand_tern_poly(t, N);
+    ring_add_tern_c99(r1, t, N);
+    ring_add_tern(r2, t, N);
+    for (i = 0; i < N; i ++) err |= (r1[i] != r2[i]);
+  }
+  printf("ring_mul_tern_prodform/ring_add_tern (N=" TEST_DIMS "): %s\n", \
+         err ? "FAILED" : "OK");
+}
+
+
+#ifndef __AVR__
+
+
+// Comparison of ring_mul_tern_sparse_swar against ring_mul_tern_sparse_c99 for
+// the test vectors of test_ring_mul_11 and test_ring_mul_401 (for the latter,
+// each of the three sparse polynomials of b(x) is multiplied by a(x)). The
+// result-arrays are initialized with non-0 values so that the accumulation of
+// the existing coefficients (MAC operation) is covered as well.
+
+void test_ring_mul_swar_cmp(void)
+{
+  int i, k, err = 0;
+  uint16_t a11[18] = { 8, 25, 22, 20, 12, 24, 15, 19, 12, 19, 16, 8, 25, 22, \
+                       20, 12, 24, 15 };
+  uint16_t b11[6] = { 2, 3, 4, 0, 5, 7 };
+  uint16_t a401[408] = { A401COEFFS }; // see ring_arith_test.h for A401COEFFS
+  uint16_t b401[44] = { B401INDICES }; // see ring_arith_test.h for B401INDICES
+  int off[3] = { 0, 16, 32 }, len[3] = { 16, 16, 12 };
+  uint16_t z1[408], z2[408];
+
+  for (i = 0; i < 16; i ++) z1[i] = z2[i] = (uint16_t) (0xFFF0 + i);
+  ring_mul_tern_sparse_c99(z1, a11, b11, 6, 11);
+  ring_mul_tern_sparse_swar(z2, a11, b11, 6, 11);
+  for (i = 0; i < 11; i ++) err |= (z1[i] != z2[i]);
+  for (i = 0; i < 7; i ++) a401[401+i] = a401[i];
+  for (k = 0; k < 3; k ++) {
+    for (i = 0; i < 408; i ++) z1[i] = z2[i] = (uint16_t) (i*0x2F1);
+    ring_mul_tern_sparse_c99(z1, a401, &b401[off[k]], len[k], 401);
+    ring_mul_tern_sparse_swar(z2, a401, &b401[off[k]], len[k], 401);
+    for (i = 0; i < 401; i ++) err |= (z1[i] != z2[i]);
+  }
+  printf("ring_mul_tern_sparse_swar (N=11,401): %s\n", \
+         err ? "FAILED" : "OK");
+}
+
+
+// Comparison of ring_mul_tern_prodform_multi against separate invocations of
+// ring_mul_tern_prodform for 11 ring-elements (EES743EP1 dimensions) that are
+// multiplied by one and the same product-form polynomial.
+
+void test_ring_mul_multi_cmp(void)
+{
+  int i, k, N = 743, num = 11, err = 0;
+  uint16_t a[11][743+7], bidx[52], start[52], r1[11][744], r2[744];
+  uint16_t *rk[11];
+  const uint16_t *ak[11];
+  prod_form_poly_t b = { bidx, 22, 22, 8 };
+  prod_form_prep_t p;
+
+  rand_sparse_poly(&bidx[0], 22, N);
+  rand_sparse_poly(&bidx[22], 22, N);
+  rand_sparse_poly(&bidx[44], 8, N);
+  for (k = 0; k < num; k ++) {
+    rand_ring_elem(a[k], N);
+    ak[k] = a[k]; rk[k] = r1[k];
+  }
+  ring_prep_prodform(&p, start, &b, N);
+  ring_mul_tern_prodform_multi(rk, ak, &p, num);
+  for (k = 0; k < num; k ++) {
+    ring_red_modq(rk[k], rk[k], AVRNTRU_Q, N);  // products are unreduced
+    ring_mul_tern_prodform(r2, a[k], &b, N);
+    for (i = 0; i < N; i ++) err |= (r1[k][i] != r2[i]);
+  }
+  printf("ring_mul_tern_prodform_multi (N=%i, num=%i): %s\n", N, num, \
+         err ? "FAILED" : "OK");
+}
+
+
+
+// Helper function for test_ring_tern: <mod3> reduces an integer modulo 3 to
+// 0, 1, or 0xFFFF.
+
+static uint16_t mod3(int c)
+{
+  c = ((c % 3) + 3) % 3;
+  return (c == 2) ? 0xFFFF : (uint16_t) c;
+}
+
+
+// Bit-sliced ternary polynomials for the dimensions 11, 32, 401, and 743: the
+// conversion from and to the dense representation, the addition and
+// subtraction modulo 3, and the multiplication by a sparse ternary polynomial
+// v(x) (which contains the indices 0 and N-1) accumulated to a random r(x) are
+// compared with the dense arithmetic, i.e. ring_mul_tern_sparse_c99 with the
+// operand a(x) followed by a reduction modulo 3.
+
+void test_ring_tern(void)
+{
+  int dims[4] = { 11, 32, 401, 743 }, vlens[4] = { 6, 10, 16, 30 };
+  int i, k, N, vlen, err = 0;
+  uint16_t a[AVRNTRU_MAX_DIM+7], b[AVRNTRU_MAX_DIM], c[AVRNTRU_MAX_DIM];
+  uint16_t z[AVRNTRU_MAX_DIM+7], v[AVRNTRU_MAX_NZC];
+  uint32_t ta[RING_TERN_LEN(AVRNTRU_MAX_DIM)];
+  uint32_t tb[RING_TERN_LEN(AVRNTRU_MAX_DIM)];
+  uint32_t tr[RING_TERN_LEN(AVRNTRU_MAX_DIM)];
+
+  for (k = 0; k < 4; k ++) {
+    N = dims[k]; vlen = vlens[k];
+    rand_tern_poly(a, N);
+    rand_tern_poly(b, N);
+    for (i = 0; i < 7; i ++) a[N+i] = a[i];
+    rand_sparse_poly(v, vlen, N);
+    for (i = 1; (i < vlen) && (v[i] != N-1); i ++);
+    if (i == vlen) v[1] = N-1;
+    // conversion
+    ring_tern_from_dense(ta, a, N);
+    ring_tern_from_dense(tb, b, N);
+    ring_tern_to_dense(c, ta, N);
+    for (i = 0; i < N; i ++) err |= (c[i] != a[i]);
+    // addition and subtraction
+    ring_tern_add(tr, ta, tb, N);
+    ring_tern_to_dense(c, tr, N);
+    for (i = 0; i < N; i ++)
+      err |= (c[i] != mod3((int16_t) a[i] + (int16_t) b[i]));
+    ring_tern_sub(tr, ta, tb, N);
+    ring_tern_to_dense(c, tr, N);
+    for (i = 0; i < N; i ++)
+      err |= (c[i] != mod3((int16_t) a[i] - (int16_t) b[i]));
+    // multiplication r(x) = b(x) + a(x)*v(x) mod 3
+    for (i = 0; i < ((N+7)&(-8)); i ++) z[i] = 0;
+    ring_mul_tern_sparse_c99(z, a, v, vlen, N);
+    for (i = 0; i < RING_TERN_LEN(N); i ++) tr[i] = tb[i];
+    ring_tern_mul_sparse(tr, ta, v, vlen, N);
+    ring_tern_to_dense(c, tr, N);
+    for (i = 0; i < N; i ++)
+      err |= (c[i] != mod3((int16_t) z[i] + (int16_t) b[i]));
+    // the bits beyond x^(N-1) must be 0
+    if (N & 31) err |= (tr[RING_TERN_WORDS(N)-1] >> (N & 31)) != 0;
+    if (N & 31) err |= (tr[RING_TERN_LEN(N)-1] >> (N & 31)) != 0;
+  }
+  printf("ring_tern (N=11/32/401/743): %s\n", err ? "FAILED" : "OK");
+}
+
+
+
+// Lazy reduction: the product-form multiplications must give the same result
+// when the coefficients of the operand are not reduced modulo q, i.e. when a
+// random multiple of q is added to each of them (EES743EP1 dimensions).
+
+void test_ring_mul_lazy(void)
+{
+  int i, N = 743, err = 0;
+  uint16_t e[743+7], e2[743+7], fidx[74], m1[744], m2[744];
+  prod_form_poly_t F = { fidx, 22, 22, 30 };
+
+  rand_ring_elem(e, N);
+  for (i = 0; i < N; i ++) e2[i] = e[i] + (uint16_t) (lcg_next()*AVRNTRU_Q);
+  for (i = 0; i < 7; i ++) e2[N+i] = e2[i];
+  rand_sparse_poly(&fidx[0], 22, N);
+  rand_sparse_poly(&fidx[22], 22, N);
+  rand_sparse_poly(&fidx[44], 30, N);
+  ring_mul_tern_prodform(m1, e, &F, N);
+  ring_mul_tern_prodform(m2, e2, &F, N);
+  for (i = 0; i < N; i ++) err |= (m1[i] != m2[i]);
+  ring_mul_tern_prodform_mod3(m1, e, &F, N);
+  ring_mul_tern_prodform_mod3(m2, e2, &F, N);
+  for (i = 0; i < N; i ++) err |= (m1[i] != m2[i]);
+  printf("ring_mul_tern_prodform (N=%i, unreduced): %s\n", N, \
+         err ? "FAILED" : "OK");
+}
+
+
+// Compare ring_mul_tern_sparse2_part_c99 and the suffix-less version of
+// ring_mul_tern_sparse2_part with ring_mul_tern_sparse2_c99 for the three
+// parameter sets, whereby the coefficients are computed in the ranges of
+// blocks that a pool of 1 to 8 threads would get (see ring_mt.c). In this way
+// the ranges are tested even when the pool is limited to a single thread.
+
+void test_ring_mul_sparse2_part_cmp(void)
+{
+  int param[3][3] = { { 401, 16, 12 }, { 443, 16, 10 }, { 743, 22, 30 } };
+  uint16_t u[743+7], w[743+7], idx[52], z1[744], z2[744], z3[744];
+  int i, k, n, t, N, nblk, lo, hi, err = 0;
+
+  for (k = 0; k < 3; k ++) {
+    N = param[k][0];
+    nblk = (N + 7) >> 3;
+    rand_ring_elem(u, N);
+    rand_ring_elem(w, N);
+    rand_sparse_poly(&idx[0], param[k][1], N);
+    rand_sparse_poly(&idx[param[k][1]], param[k][2], N);
+    ring_mul_tern_sparse2_c99(z1, u, w, idx, param[k][1], param[k][2], N);
+    for (n = 1; n <= 8; n ++) {
+      for (t = 0; t < n; t ++) {
+        lo = ((t*nblk)/n) << 3;
+        hi = (((t + 1)*nblk)/n) << 3;
+        if (hi > N) hi = N;
+        if (lo >= hi) continue;
+        ring_mul_tern_sparse2_part_c99(z2, u, w, idx, param[k][1], \
+                                       param[k][2], lo, hi, N);
+        ring_mul_tern_sparse2_part(z3, u, w, idx, param[k][1], \
+                                   param[k][2], lo, hi, N);
+      }
+      for (i = 0; i < N; i ++) err |= (z1[i] != z2[i]) | (z1[i] != z3[i]);
+    }
+  }
+  printf("ring_mul_tern_sparse2_part (N=401,443,743): %s\n", \
+         err ? "FAILED" : "OK");
+}
+
+
+#ifdef AVRNTRU_DISPATCH
+
+// Comparison of every kernel of the registry that is supported by the
+// processor against the C99 reference implementation of ring_mul_tern_sparse
+// and of ring_mul_tern_sparse2 (and their "part" and "wide" versions) as well
+// as of ring_mul_tern_sparse_multi for the three parameter sets. The
+// suffix-less functions are used to check that the selection via
+// ring_kernel_select takes effect. The operands have AVRNTRU_PUBKEY_PAD
+// wrap-around elements, which the "wide" versions require.
+
+void test_ring_kernels(void)
+{
+  int param[3][4] = { { 401, 16, 16, 12 }, { 443, 18, 16, 10 }, \
+                      { 743, 22, 22, 30 } };
+  uint16_t u[743+AVRNTRU_PUBKEY_PAD], w[743+AVRNTRU_PUBKEY_PAD], idx[74];
+  uint16_t z1[744], z2[744], z3[744], start[18];
+  uint16_t *zk[2] = { z2, z3 };
+  const uint16_t *uk[2] = { u, w };
+  const ring_kernel_t *kern;
+  int i, k, n, N, err;
+
+  for (n = 0; n < ring_kernel_num(); n ++) {
+    kern = ring_kernel_get(n);
+    if (!kern->supported()) {
+      printf("ring kernel %s: not supported\n", kern->name);
+      continue;
+    }
+    err = (ring_kernel_select(kern->name) != kern);
+    for (k = 0; k < 3; k ++) {
+      N = param[k][0];
+      rand_ring_elem(u, N);
+      rand_ring_elem(w, N);
+      for (i = 7; i < AVRNTRU_PUBKEY_PAD; i ++) {
+        u[N+i] = u[i]; w[N+i] = w[i];
+      }
+      rand_sparse_poly(&idx[0], param[k][1], N);
+      rand_sparse_poly(&idx[param[k][1]], param[k][3], N);
+      for (i = 0; i < 744; i ++) z1[i] = z2[i] = 0;
+      ring_mul_tern_sparse_c99(z1, u, idx, param[k][1], N);
+      ring_mul_tern_sparse(z2, u, idx, param[k][1], N);
+      for (i = 0; i < N; i ++) err |= (z1[i] != z2[i]);
+      for (i = 0; i < 744; i ++) z2[i] = 0;
+      ring_mul_tern_sparse_wide(z2, u, idx, param[k][1], N);
+      for (i = 0; i < N; i ++) err |= (z1[i] != z2[i]);
+      for (i = 0; i < param[k][1]; i ++)
+        start[i] = (idx[i] == 0) ? 0 : N - idx[i];
+      for (i = 0; i < 744; i ++) z2[i] = z3[i] = 0;
+      ring_mul_tern_sparse_multi(zk, uk, start, param[k][1], 2, N);
+      for (i = 0; i < N; i ++) err |= (z1[i] != z2[i]);
+      for (i = 0; i < 744; i ++) z1[i] = 0;
+      ring_mul_tern_sparse_c99(z1, w, idx, param[k][1], N);
+      for (i = 0; i < N; i ++) err |= (z1[i] != z3[i]);
+      ring_mul_tern_sparse2_c99(z1, u, w, idx, param[k][1], param[k][3], N);
+      ring_mul_tern_sparse2(z2, u, w, idx, param[k][1], param[k][3], N);
+      for (i = 0; i < N; i ++) err |= (z1[i] != z2[i]);
+      ring_mul_tern_sparse2_part(z2, u, w, idx, param[k][1], param[k][3], \
+                                 0, N, N);
+      for (i = 0; i < N; i ++) err |= (z1[i] != z2[i]);
+      ring_mul_tern_sparse2_wide(z2, u, w, idx, param[k][1], param[k][3], N);
+      for (i = 0; i < N; i ++) err |= (z1[i] != z2[i]);
+    }
+    printf("ring kernel %s: %s\n", kern->name, err ? "FAILED" : "OK");
+  }
+  ring_kernel_init();
+}
+
+#endif  // AVRNTRU_DISPATCH
+
+#ifdef AVRNTRU_USE_THREADS
+
+// Compare ring_mul_tern_prodform_mt with ring_mul_tern_prodform for the three
+// parameter sets and pools of 1 to AVRNTRU_MAX_THREADS threads, which covers
+// ranges of different size and threads without any block.
+
+void test_ring_mul_prodform_mt(void)
+{
+  int i, k, n, N, err = 0;
+  int param[3][4] = { { 401, 16, 16, 12 }, { 443, 18, 16, 10 }, \
+                      { 743, 22, 22, 30 } };
+  uint16_t a[743+7], idx[74], r1[744], r2[744];
+  prod_form_poly_t b;
+  ring_pool_t pool;
+
+  for (n = 1; n <= AVRNTRU_MAX_THREADS; n ++) {
+    if (ring_pool_init(&pool, n) != AVRNTRU_NO_ERROR) {
+      err = 1;
+      break;
+    }
+    for (k = 0; k < 3; k ++) {
+      N = param[k][0];
+      b.indices = idx;
+      b.num_nzc_poly1 = param[k][1];
+      b.num_nzc_poly2 = param[k][2];
+      b.num_nzc_poly3 = param[k][3];
+      rand_ring_elem(a, N);
+      rand_sparse_poly(&idx[0], param[k][1], N);
+      rand_sparse_poly(&idx[param[k][1]], param[k][2], N);
+      rand_sparse_poly(&idx[param[k][1]+param[k][2]], param[k][3], N);
+      ring_mul_tern_prodform(r1, a, &b, N);
+      ring_mul_tern_prodform_mt(&pool, r2, a, &b, N);
+      for (i = 0; i < N; i ++) err |= (r1[i] != r2[i]);
+    }
+    ring_pool_free(&pool);
+  }
+  printf("ring_mul_tern_prodform_mt (threads=1..%i): %s\n", \
+         AVRNTRU_MAX_THREADS, err ? "FAILED" : "OK");
+}
+
+#endif  // AVRNTRU_USE_THREADS
+
+#endif  // __AVR__
+
+
 int main(void)
 {
 #ifdef __AVR__
@@ -97,6 +627,23 @@ int main(void)
   
   test_ring_mul_11();
   test_ring_mul_401();
+  test_ring_mul_sparse_cmp();
+  test_ring_mul_mod3_cmp();
+  test_ring_pack();
+  test_ring_mul_prodform_cmp();
+#ifndef __AVR__
+  test_ring_mul_swar_cmp();
+  test_ring_mul_multi_cmp();
+  test_ring_tern();
+  test_ring_mul_lazy();
+  test_ring_mul_sparse2_part_cmp();
+#ifdef AVRNTRU_DISPATCH
+  test_ring_kernels();
+#endif
+#ifdef AVRNTRU_USE_THREADS
+  test_ring_mul_prodform_mt();
+#endif
+#endif
   
   // testmod3();
   
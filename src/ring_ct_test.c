@@ -0,0 +1,596 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_ct_test.c: Constant-Time Tests of the Ring Arithmetic.               //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+// This program checks whether the execution time of the multiplications by a
+// sparse ternary polynomial and by a product-form polynomial depends on the
+// indices of the non-0 coefficients of the sparse polynomials, which are the
+// secret in the NTRU decryption (private key) and encryption (blinding
+// polynomial). Every function is executed with two classes of inputs, namely
+// a fixed sparse polynomial with the indices 0, 1, ..., vlen-1 (i.e. all
+// non-0 coefficients are in the first block and all streams wrap around at
+// the same time) and fresh random sparse polynomials, whereby the class of
+// each run is chosen at random. This is the "fixed-vs-random" test of the
+// paper "Dude, is my code constant time?" by Reparaz et al. (DATE 2017). The
+// ring-element u(x) is the same for both classes.
+//
+// On AVR, the execution time of a function is deterministic (there are no
+// caches or branch predictors), i.e. a function runs in constant time if and
+// only if all runs take exactly the same number of cycles, which is measured
+// with the 16-bit Timer1 (no prescaling) and a counter of timer overflows. The
+// program is meant to be executed in a simulator like simavr, whereby a leak
+// is reported as "LEAK" together with the minimum and maximum cycle count:
+//
+// avr-gcc -mmcu=atmega128 -O2 -DAVRNTRU_USE_ASM -o ct.elf ring_ct_test.c
+//         ring_arith.c ring_tern.c utils.c avrasm/*.S
+// simavr -m atmega128 -f 16000000 ct.elf
+//
+// On a host processor, the execution times are measured with the time-stamp
+// counter (or the monotonic clock) and compared with Welch's t-test, which is
+// performed on all samples as well as on subsets cropped at several
+// percentiles, like in dudect (see ct_ttest). A function leaks when the
+// absolute value of the t-statistic exceeds CT_T_MAX (or the threshold given
+// with option -t) in the majority of CT_ROUNDS rounds of measurements, i.e.
+// when the execution times of the two classes differ by more than can be
+// explained by noise. All tested functions load the coefficients of u(x) at
+// offsets that depend on the secret indices, which is constant-time on AVR,
+// but not on a host with caches, store-to-load forwarding, and branch
+// predictors: the execution time also depends on the alignment of the loads
+// (e.g. loads that cross a cache line) and on the addresses the predictors
+// learn, which differ between the two classes by a few dozen cycles and are
+// detected in some of the runs. Such a leak of a function that is marked
+// with CT_CACHE is reported as "LEAK (cache level)" on the host, but does not
+// affect the exit status, i.e. these functions are not constant-time at the
+// cache level and must not be used where this matters. To make sure that the
+// test is able to detect a leak at all, it also checks a deliberately leaky
+// variant of the sparse multiplication, which has to be reported as leaking.
+// The exit status is 1 if a function that is expected to be constant-time
+// leaks or the leaky variant is not detected, so that the program can serve
+// as a check in the build process (e.g. after optimizing a kernel):
+//
+// gcc -std=c99 -O2 -mavx2 -o ct ring_ct_test.c ring_arith.c ring_tern.c
+//     utils.c -lm
+// ./ct [-n measurements] [-t threshold]
+
+#if !defined(__AVR__) && defined(__linux__)
+#define _GNU_SOURCE  // clock_gettime
+#endif
+
+#include <stdio.h>
+#include "config.h"
+#include "ring_arith.h"
+#include "ring_tern.h"
+#include "utils.h"
+
+#ifdef __AVR__
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static FILE mystdout = FDEV_SETUP_STREAM(uart_putch, NULL, _FDEV_SETUP_WRITE);
+
+#define CT_RUNS 16  // number of runs per function and dimension
+
+// Highest dimension that is tested (the ATmega128 has only 4 kB of RAM)
+#if RAMEND > 0x10FF
+#define CT_MAX_DIM 743
+#else
+#define CT_MAX_DIM 443
+#endif
+
+#else  // host processor, e.g. x86
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+#define CT_RUNS 50000       // default number of measurements per function
+#define CT_MAX_RUNS 200000  // maximum number of measurements per function
+#define CT_WARMUP 1000      // number of runs before the measurement
+#define CT_T_MAX 10.0       // default threshold for the t-statistic
+#define CT_ROUNDS 5         // number of t-tests for the majority vote
+#define CT_CROPS 20         // number of cropped t-tests (see ct_ttest)
+#define CT_MAX_DIM 743
+
+#endif  // __AVR__
+
+// Type of the tested function: sparse multiplication, sum of two sparse
+// multiplications, product-form multiplication, or the multiplication of a
+// bit-sliced ternary polynomial (see ring_tern.c)
+
+enum { CT_SPARSE, CT_SPARSE2, CT_PRODFORM, CT_TERN };
+
+// Expected result of the test of a function: constant execution time, leak
+// through the caches (and other micro-architectural state) of a host since
+// the function loads operands at addresses that depend on the secret indices
+// (no leak on AVR), or leak on all platforms (deliberately leaky function)
+
+enum { CT_CONST, CT_CACHE, CT_LEAKY };
+
+typedef struct ct_func {
+  const char *name;
+  int type;
+  void (*sparse)(uint16_t *r, const uint16_t *u, const uint16_t *v, int vlen,
+                 int N);
+  void (*sparse2)(uint16_t *r, const uint16_t *u, const uint16_t *w,
+                  const uint16_t *v, int vlen1, int vlen2, int N);
+  void (*prodform)(uint16_t *r, const uint16_t *a, const prod_form_poly_t *b,
+                   int N);
+  int expect;                 // expected result (CT_CONST, CT_CACHE, ...)
+} ct_func_t;
+
+// Operands of the tested functions, which are large enough for CT_MAX_DIM and
+// the wrap-around elements of the "wide" AVX2 version. The array <u> is also
+// used as operand w(x) in the sums of two products to save RAM.
+
+static uint16_t u[CT_MAX_DIM+15], z[CT_MAX_DIM+15], idx[3*AVRNTRU_MAX_NZC];
+static uint32_t ta[RING_TERN_LEN(CT_MAX_DIM)], tr[RING_TERN_LEN(CT_MAX_DIM)];
+static int ct_N, ct_vlen[3];
+
+
+// Simple linear congruential generator to produce reproducible operands
+
+static uint32_t lcg_state = 1;
+
+static uint16_t lcg_next(void)
+{
+  lcg_state = lcg_state*1103515245UL + 12345UL;
+  return (uint16_t) (lcg_state >> 16);
+}
+
+
+// The function <ct_leaky> computes the same product as the function
+// <ring_mul_tern_sparse_c99>, but takes a shortcut for the indices j < 8 of
+// the non-0 coefficients of v(x): the rotated u(x) wraps around within the
+// first eight coefficients of the product, after which the coefficients can
+// be processed without index arithmetic. This (seemingly harmless) shortcut
+// makes the execution time depend on the number of indices below 8, which is
+// eight for the fixed class, but mostly 0 for the random class. The function
+// is used to verify that the test is able to detect a leak.
+
+static void ct_leaky(uint16_t *r, const uint16_t *u, const uint16_t *v,
+                     int vlen, int N)
+{
+  int i, j, k;
+  uint16_t m;
+
+  for (j = 0; j < vlen; j ++) {
+    m = (j < vlen/2) ? 0 : 0xFFFF;  // m = -1 for the "-1" coefficients
+    k = v[j];
+    if (k < 8) {
+      for (i = 0; i < k; i ++) r[i] += (u[N-k+i] ^ m) - m;
+      for (i = k; i < N; i ++) r[i] += (u[i-k] ^ m) - m;
+      continue;
+    }
+    for (i = 0, k = N - k; i < N; i ++) {
+      r[i] += (u[k] ^ m) - m;
+      k = (k + 1 == N) ? 0 : k + 1;
+    }
+  }
+}
+
+#if defined(__AVR__) && defined(AVRNTRU_USE_ASM)
+static void ct_sparse_avr(uint16_t *r, const uint16_t *u, const uint16_t *v,
+                          int vlen, int N)
+{
+  ring_mul_tern_sparse_avr(r, u, (uint16_t *) v, vlen, N);
+}
+#endif
+
+// List of the tested functions. The product-form multiplications use the
+// functions that are selected in config.h.
+
+static const ct_func_t ct_funcs[] = {
+  { "ring_mul_tern_sparse_c99", CT_SPARSE, \
+    ring_mul_tern_sparse_c99, NULL, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse_V2", CT_SPARSE, \
+    ring_mul_tern_sparse_V2, NULL, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse2_c99", CT_SPARSE2, \
+    NULL, ring_mul_tern_sparse2_c99, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse_mod3_c99", CT_SPARSE, \
+    ring_mul_tern_sparse_mod3_c99, NULL, NULL, CT_CACHE },
+#if defined(__AVR__) && defined(AVRNTRU_USE_ASM)
+  { "ring_mul_tern_sparse_avr", CT_SPARSE, \
+    ct_sparse_avr, NULL, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse2_avr", CT_SPARSE2, \
+    NULL, ring_mul_tern_sparse2_avr, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse_mod3_avr", CT_SPARSE, \
+    ring_mul_tern_sparse_mod3_avr, NULL, NULL, CT_CACHE },
+#endif
+#ifndef __AVR__
+  { "ring_mul_tern_sparse_swar", CT_SPARSE, \
+    ring_mul_tern_sparse_swar, NULL, NULL, CT_CACHE },
+#if defined(AVRNTRU_SPECIALIZE)
+  { "ring_mul_tern_sparse_spec", CT_SPARSE, \
+    ring_mul_tern_sparse_spec, NULL, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse2_spec", CT_SPARSE2, \
+    NULL, ring_mul_tern_sparse2_spec, NULL, CT_CACHE },
+#endif
+#if defined(__SSE2__)
+  { "ring_mul_tern_sparse_sse2", CT_SPARSE, \
+    ring_mul_tern_sparse_sse2, NULL, NULL, CT_CACHE },
+#endif
+#if defined(__AVX2__)
+  { "ring_mul_tern_sparse_avx2", CT_SPARSE, \
+    ring_mul_tern_sparse_avx2, NULL, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse_wide_avx2", CT_SPARSE, \
+    ring_mul_tern_sparse_wide_avx2, NULL, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse2_avx2", CT_SPARSE2, \
+    NULL, ring_mul_tern_sparse2_avx2, NULL, CT_CACHE },
+  { "ring_mul_tern_sparse2_wide_avx2", CT_SPARSE2, \
+    NULL, ring_mul_tern_sparse2_wide_avx2, NULL, CT_CACHE },
+#endif
+#if defined(__AVX512BW__)
+  { "ring_mul_tern_sparse_avx512", CT_SPARSE, \
+    ring_mul_tern_sparse_avx512, NULL, NULL, CT_CACHE },
+#endif
+#endif  // __AVR__
+  { "ring_mul_tern_prodform", CT_PRODFORM, \
+    NULL, NULL, ring_mul_tern_prodform, CT_CACHE },
+  { "ring_mul_tern_prodform_mod3", CT_PRODFORM, \
+    NULL, NULL, ring_mul_tern_prodform_mod3, CT_CACHE },
+  { "ring_tern_mul_sparse", CT_TERN, \
+    NULL, NULL, NULL, CT_CACHE },
+  { "ct_leaky", CT_SPARSE, \
+    ct_leaky, NULL, NULL, CT_LEAKY }
+};
+
+
+// The function <ct_indices> writes the indices of the sparse polynomial(s) of
+// the given class to the array <idx>, i.e. the indices 0, 1, ..., vlen-1 for
+// the fixed class (cls = 0) and random distinct indices for the random class
+// (cls = 1). There are up to three sparse polynomials with ct_vlen[0] to
+// ct_vlen[2] non-0 coefficients, whose indices are stored one after the other.
+// The random indices are generated for both classes and the fixed indices are
+// selected via a mask, so that the preparation of the input does the same
+// work and leaves the same state (e.g. in the caches) for both classes.
+
+static void ct_indices(int cls)
+{
+  uint16_t rnd[3*AVRNTRU_MAX_NZC], mask = (uint16_t) -cls;
+  int i, j, k, len = 0;
+
+  for (k = 0; k < 3; k ++) {
+    for (i = len; i < len + ct_vlen[k]; i ++) {
+      do {
+        rnd[i] = lcg_next() % ct_N;
+        for (j = len; (j < i) && (rnd[j] != rnd[i]); j ++);
+      } while (j < i);
+      idx[i] = (rnd[i] & mask) | ((i - len) & ~mask);
+    }
+    len += ct_vlen[k];
+  }
+}
+
+
+// The function <ct_run> executes the function <cf> once with the operands in
+// the global arrays.
+
+static void ct_run(const ct_func_t *cf)
+{
+  prod_form_poly_t b = { idx, ct_vlen[0], ct_vlen[1], ct_vlen[2] };
+
+  switch (cf->type) {
+    case CT_SPARSE:
+      cf->sparse(z, u, idx, ct_vlen[0], ct_N);
+      break;
+    case CT_SPARSE2:
+      cf->sparse2(z, u, u, idx, ct_vlen[0], ct_vlen[1], ct_N);
+      break;
+    case CT_PRODFORM:
+      cf->prodform(z, u, &b, ct_N);
+      break;
+    default:
+      ring_tern_mul_sparse(tr, ta, idx, ct_vlen[0], ct_N);
+  }
+}
+
+#ifdef __AVR__
+
+volatile uint16_t ct_ovf;  // number of timer overflows
+
+
+// Interrupt service routine for the overflow of Timer1. Its execution time is
+// included in the cycle count, but does not depend on the measured function,
+// i.e. two runs of the same length have the same cycle count.
+
+ISR(TIMER1_OVF_vect)
+{
+  ct_ovf ++;
+}
+
+
+// The function <ct_cycles> executes the function <cf> and returns the number
+// of cycles it took, including the overflow-ISRs and the overhead of starting
+// and stopping the timer (see bench_cycles in ring_arith_bench.c).
+
+static uint32_t ct_cycles(const ct_func_t *cf)
+{
+  uint32_t ovf;
+  uint16_t cnt;
+
+  TCCR1B = 0;
+  TCNT1 = 0;
+  ct_ovf = 0;
+  TIFR = _BV(TOV1);
+  TIMSK |= _BV(TOIE1);
+  sei();
+  TCCR1B = _BV(CS10);  // start Timer1 without prescaling
+  ct_run(cf);
+  TCCR1B = 0;          // stop Timer1
+  cli();
+  cnt = TCNT1;
+  ovf = ct_ovf;
+  if (TIFR & _BV(TOV1)) {  // overflow after the last ISR
+    TIFR = _BV(TOV1);
+    ovf ++;
+  }
+  TIMSK &= ~_BV(TOIE1);
+
+  return (ovf << 16) + cnt;
+}
+
+
+// The function <ct_check> executes the function <cf> CT_RUNS times with inputs
+// of the fixed and the random class (in random order) and returns 1 if not all
+// runs have the same cycle count, and 0 otherwise.
+
+static int ct_check(const ct_func_t *cf)
+{
+  uint32_t cyc, min = 0xFFFFFFFFUL, max = 0;
+  int k;
+
+  for (k = 0; k < CT_RUNS; k ++) {
+    ct_indices(lcg_next() & 1);
+    cyc = ct_cycles(cf);
+    if (cyc < min) min = cyc;
+    if (cyc > max) max = cyc;
+  }
+  printf("%s (N=%i): ", cf->name, ct_N);
+  if (min == max) printf("%lu cycles, ", (unsigned long) min);
+  else printf("%lu-%lu cycles, ", (unsigned long) min, (unsigned long) max);
+
+  return (min != max);
+}
+
+#else  // host processor, e.g. x86
+
+static int ct_num = CT_RUNS;         // number of measurements per function
+static double ct_tmax = CT_T_MAX;    // threshold for the t-statistic
+static uint64_t ct_time_buf[CT_MAX_RUNS], ct_sort_buf[CT_MAX_RUNS];
+static uint8_t ct_class_buf[CT_MAX_RUNS];
+
+
+// The function <ct_time> returns the current value of the time-stamp counter
+// on x86 processors, and the monotonic time in nanoseconds otherwise (see
+// bench_time in ring_arith_bench.c).
+
+static uint64_t ct_time(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  uint64_t t;
+
+  _mm_lfence();
+  t = __rdtsc();
+  _mm_lfence();
+
+  return t;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t) ts.tv_sec*1000000000ULL + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+
+// Comparison function for qsort
+
+static int ct_cmp(const void *a, const void *b)
+{
+  uint64_t x = *((const uint64_t *) a), y = *((const uint64_t *) b);
+
+  return (x > y) - (x < y);
+}
+
+
+// The function <ct_ttest> measures the function <cf> <ct_num> times with
+// inputs of the fixed and the random class (in random order) and performs
+// Welch's t-test for the means and variances of the two classes (obtained
+// through Welford's online algorithm). Like dudect, it performs the t-test not
+// only on all samples, but also on CT_CROPS subsets that only contain the
+// samples below a certain percentile, namely 1 - 0.5^(10*c/CT_CROPS) for c =
+// 1, ..., CT_CROPS (i.e. from about 29% to 99.9%). Cropping removes the long
+// tail of the distribution (e.g. runs that were interrupted), which would
+// otherwise hide a small difference of the execution times. The return value
+// is the t-statistic with the largest absolute value.
+
+static double ct_ttest(const ct_func_t *cf)
+{
+  double n[CT_CROPS+1][2], mean[CT_CROPS+1][2], m2[CT_CROPS+1][2];
+  double x, d, t, tmax = 0.0;
+  uint64_t t0, crop[CT_CROPS+1];
+  int c, k, cls;
+
+  for (k = -CT_WARMUP; k < ct_num; k ++) {
+    cls = lcg_next() & 1;
+    ct_indices(cls);
+    t0 = ct_time();
+    ct_run(cf);
+    if (k < 0) continue;
+    ct_time_buf[k] = ct_time() - t0;
+    ct_class_buf[k] = (uint8_t) cls;
+  }
+  memcpy(ct_sort_buf, ct_time_buf, ct_num*sizeof(ct_time_buf[0]));
+  qsort(ct_sort_buf, ct_num, sizeof(ct_sort_buf[0]), ct_cmp);
+  crop[0] = ct_sort_buf[ct_num-1];
+  for (c = 1; c <= CT_CROPS; c ++) {
+    k = (int) (ct_num*(1.0 - pow(0.5, (10.0*c)/CT_CROPS)));
+    crop[c] = ct_sort_buf[k];
+  }
+
+  for (c = 0; c <= CT_CROPS; c ++) {
+    n[c][0] = n[c][1] = mean[c][0] = mean[c][1] = m2[c][0] = m2[c][1] = 0.0;
+  }
+  for (k = 0; k < ct_num; k ++) {
+    cls = ct_class_buf[k];
+    x = (double) ct_time_buf[k];
+    for (c = 0; c <= CT_CROPS; c ++) {
+      if (ct_time_buf[k] > crop[c]) continue;
+      n[c][cls] += 1.0;
+      d = x - mean[c][cls];
+      mean[c][cls] += d/n[c][cls];
+      m2[c][cls] += d*(x - mean[c][cls]);
+    }
+  }
+
+  for (c = 0; c <= CT_CROPS; c ++) {
+    if ((n[c][0] < 2.0) || (n[c][1] < 2.0)) continue;
+    d = m2[c][0]/(n[c][0]*(n[c][0] - 1.0)) + \
+        m2[c][1]/(n[c][1]*(n[c][1] - 1.0));
+    if (d <= 0.0) continue;
+    t = (mean[c][0] - mean[c][1])/sqrt(d);
+    if (fabs(t) > fabs(tmax)) tmax = t;
+  }
+
+  return tmax;
+}
+
+
+// The function <ct_check> performs up to CT_ROUNDS independent t-tests of the
+// function <cf> and returns 1 if the absolute value of the t-statistic exceeds
+// <ct_tmax> in the majority of them, and 0 otherwise. A host is a noisy
+// environment (e.g. other processes, changes of the clock frequency), which
+// occasionally pushes the t-statistic of a constant-time function above the
+// threshold for one round, whereas a real leak shows up in most rounds. The
+// rounds stop as soon as the majority is decided.
+
+static int ct_check(const ct_func_t *cf)
+{
+  double t;
+  int k, above = 0;
+
+  printf("%s (N=%i): t =", cf->name, ct_N);
+  for (k = 1; k <= CT_ROUNDS; k ++) {
+    t = ct_ttest(cf);
+    printf(" %.2f,", t);
+    above += (fabs(t) > ct_tmax);
+    if ((2*above > CT_ROUNDS) || (2*(k - above) > CT_ROUNDS)) break;
+  }
+  printf(" ");
+
+  return (2*above > CT_ROUNDS);
+}
+
+#endif  // __AVR__
+
+
+// Test of all functions for the three parameter sets. The number of non-0
+// coefficients of the sparse multiplications corresponds to the largest
+// sparse polynomial of the product-form polynomials (i.e. 16, 18, and 30),
+// while the sums of two products use the sizes of f2(x) and f3(x), like in
+// ring_arith_bench.c. The return value is the number of functions that leak
+// plus the number of leaky functions whose leak has not been detected, except
+// for the leaks of functions marked with CT_CACHE on a host (see above).
+
+static int ct_ring_arith(void)
+{
+  int param[3][5] = { { 401, 16, 16, 16, 12 }, { 443, 18, 18, 16, 10 }, \
+                      { 743, 30, 22, 22, 30 } };
+  int i, k, f, leak, fail = 0;
+  int nf = (int) (sizeof(ct_funcs)/sizeof(ct_funcs[0]));
+  const ct_func_t *cf;
+
+  for (k = 0; k < 3; k ++) {
+    ct_N = param[k][0];
+    if (ct_N > CT_MAX_DIM) continue;
+    for (i = 0; i < ct_N; i ++) u[i] = lcg_next() & AVRNTRU_Q_MASK;
+    for (i = 0; i < 15; i ++) u[ct_N+i] = u[i];
+    for (i = 0; i < ct_N; i ++) z[i] = (uint16_t) (lcg_next() % 3 - 1);
+    ring_tern_from_dense(ta, z, ct_N);
+    ring_tern_from_dense(tr, z, ct_N);
+    for (f = 0; f < nf; f ++) {
+      cf = &ct_funcs[f];
+      ct_vlen[0] = param[k][1]; ct_vlen[1] = ct_vlen[2] = 0;
+      if (cf->type == CT_SPARSE2) {
+        ct_vlen[0] = param[k][3]; ct_vlen[1] = param[k][4];
+      } else if (cf->type == CT_PRODFORM) {
+        ct_vlen[0] = param[k][2]; ct_vlen[1] = param[k][3];
+        ct_vlen[2] = param[k][4];
+      }
+      leak = ct_check(cf);
+      if (cf->expect == CT_LEAKY) {
+        printf("%s\n", leak ? "LEAK (expected)" : "NOT DETECTED");
+        fail += !leak;
+#ifndef __AVR__
+      } else if (cf->expect == CT_CACHE) {
+        printf("%s\n", leak ? "LEAK (cache level)" : "OK");
+#endif
+      } else {
+        printf("%s\n", leak ? "LEAK" : "OK");
+        fail += leak;
+      }
+    }
+  }
+
+  return fail;
+}
+
+
+// Without arguments, the test performs CT_RUNS measurements per function and
+// dimension. On the host, the option -n <num> sets the number of measurements,
+// and the option -t <threshold> the threshold for the t-statistic (default:
+// CT_T_MAX). The exit status is 1 if a function fails (see ct_ring_arith).
+
+#ifdef __AVR__
+int main(void)
+{
+  init_uart();
+  stdout = &mystdout;
+  ct_ring_arith();
+
+  return 0;
+}
+#else
+int main(int argc, char *argv[])
+{
+  int i, fail;
+
+  for (i = 1; i < argc - 1; i += 2) {
+    if (strcmp(argv[i], "-n") == 0) {
+      ct_num = atoi(argv[i+1]);
+    } else if (strcmp(argv[i], "-t") == 0) {
+      ct_tmax = atof(argv[i+1]);
+    } else break;
+  }
+  if ((i < argc) || (ct_num < 100) || (ct_num > CT_MAX_RUNS)) {
+    fprintf(stderr, "usage: %s [-n measurements] [-t threshold]\n", \
+            argv[0]);
+    return 2;
+  }
+  fail = ct_ring_arith();
+  if (fail > 0) fprintf(stderr, "ring_ct_test: %i function(s) failed\n", fail);
+
+  return (fail > 0);
+}
+#endif
@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_dispatch.c: Run-Time Selection of the Ring Arithmetic Kernels.       //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "ring_dispatch.h"
+
+#if defined(AVRNTRU_DISPATCH)
+
+
+// The best C99 version of ring_mul_tern_sparse2, which is used by the kernels
+// that do not have their own version of it.
+
+#if defined(AVRNTRU_SPECIALIZE)
+#define SPARSE2_C99 ring_mul_tern_sparse2_spec
+#else
+#define SPARSE2_C99 ring_mul_tern_sparse2_c99
+#endif
+
+
+// Functions to check whether the processor supports an instruction set. On
+// x86, the built-in functions of the compiler are used, which check the CPUID
+// flags and whether the operating system saves the extended registers.
+
+static int cpu_any(void)
+{
+  return 1;
+}
+
+#if defined(AVRNTRU_X86_TARGETS)
+
+static int cpu_sse2(void)
+{
+  return __builtin_cpu_supports("sse2") != 0;
+}
+
+static int cpu_avx2(void)
+{
+  return __builtin_cpu_supports("avx2") != 0;
+}
+
+static int cpu_avx512(void)
+{
+  return (__builtin_cpu_supports("avx2") != 0) && \
+         (__builtin_cpu_supports("avx512f") != 0) && \
+         (__builtin_cpu_supports("avx512bw") != 0);
+}
+
+#endif  // defined(AVRNTRU_X86_TARGETS)
+
+
+// The kernel registry, whereby the kernels are sorted according to the order
+// of preference for the automatic selection (i.e. the first kernel that is
+// supported by the processor is used). The generic C99 version is always the
+// last resort. The SWAR kernel and the in-memory variant of the C99 kernel are
+// only used when they are explicitly selected (e.g. AVRNTRU_KERNEL=swar) since
+// they are slower than the C99 kernel whenever the compiler vectorizes it.
+
+static const ring_kernel_t ring_kernels[] = {
+#if defined(AVRNTRU_X86_TARGETS)
+  { "avx512", ring_mul_tern_sparse_avx512, ring_mul_tern_sparse2_avx2, \
+    ring_mul_tern_sparse2_part_avx2, ring_mul_tern_sparse_wide_avx2, \
+    ring_mul_tern_sparse2_wide_avx2, ring_mul_tern_sparse_multi_avx2, \
+    cpu_avx512 },
+  { "avx2", ring_mul_tern_sparse_avx2, ring_mul_tern_sparse2_avx2, \
+    ring_mul_tern_sparse2_part_avx2, ring_mul_tern_sparse_wide_avx2, \
+    ring_mul_tern_sparse2_wide_avx2, ring_mul_tern_sparse_multi_avx2, \
+    cpu_avx2 },
+  { "sse2", ring_mul_tern_sparse_sse2, SPARSE2_C99, \
+    ring_mul_tern_sparse2_part_c99, ring_mul_tern_sparse_sse2, \
+    SPARSE2_C99, ring_mul_tern_sparse_multi_c99, cpu_sse2 },
+#endif
+#if defined(AVRNTRU_SPECIALIZE)
+  { "spec", ring_mul_tern_sparse_spec, ring_mul_tern_sparse2_spec, \
+    ring_mul_tern_sparse2_part_c99, ring_mul_tern_sparse_spec, \
+    ring_mul_tern_sparse2_spec, ring_mul_tern_sparse_multi_c99, cpu_any },
+#endif
+  { "c99", ring_mul_tern_sparse_c99, ring_mul_tern_sparse2_c99, \
+    ring_mul_tern_sparse2_part_c99, ring_mul_tern_sparse_c99, \
+    ring_mul_tern_sparse2_c99, ring_mul_tern_sparse_multi_c99, cpu_any },
+  { "swar", ring_mul_tern_sparse_swar, SPARSE2_C99, \
+    ring_mul_tern_sparse2_part_c99, ring_mul_tern_sparse_swar, \
+    SPARSE2_C99, ring_mul_tern_sparse_multi_c99, cpu_any },
+  { "v2", ring_mul_tern_sparse_V2, ring_mul_tern_sparse2_c99, \
+    ring_mul_tern_sparse2_part_c99, ring_mul_tern_sparse_V2, \
+    ring_mul_tern_sparse2_c99, ring_mul_tern_sparse_multi_c99, cpu_any }
+};
+
+#define NUM_KERNELS ((int) (sizeof(ring_kernels)/sizeof(ring_kernels[0])))
+
+// Index of the last kernel of the automatic selection (i.e. the "c99" kernel)
+#define LAST_AUTO_KERNEL (NUM_KERNELS - 3)
+
+
+// Forward declarations of the functions the pointers initially point to.
+
+static void sparse_first(uint16_t *r, const uint16_t *u, const uint16_t *v,
+                         int vlen, int N);
+static void sparse2_first(uint16_t *r, const uint16_t *u, const uint16_t *w,
+                          const uint16_t *v, int vlen1, int vlen2, int N);
+static void sparse2_part_first(uint16_t *r, const uint16_t *u,
+                               const uint16_t *w, const uint16_t *v,
+                               int vlen1, int vlen2, int lo, int hi, int N);
+static void sparse_wide_first(uint16_t *r, const uint16_t *u,
+                              const uint16_t *v, int vlen, int N);
+static void sparse2_wide_first(uint16_t *r, const uint16_t *u,
+                               const uint16_t *w, const uint16_t *v,
+                               int vlen1, int vlen2, int N);
+static void multi_first(uint16_t *r[], const uint16_t *u[],
+                        const uint16_t *start, int vlen, int num, int N);
+
+// The suffix-less functions ring_mul_tern_sparse, ring_mul_tern_sparse2,
+// ring_mul_tern_sparse2_part, ring_mul_tern_sparse_wide, ring_mul_tern_sparse2
+// _wide, and ring_mul_tern_sparse_multi are renamed into calls through these
+// pointers (see config.h). The other functions with several versions (e.g.
+// ring_unpack and sha256_compress_x8) are not part of the registry and are
+// still selected at compile time.
+
+void (*ring_mul_tern_sparse_ptr)(uint16_t *z, const uint16_t *u, \
+  const uint16_t *v, int vlen, int N) = sparse_first;
+void (*ring_mul_tern_sparse2_ptr)(uint16_t *z, const uint16_t *u, \
+  const uint16_t *w, const uint16_t *v, int vlen1, int vlen2, int N) = \
+  sparse2_first;
+void (*ring_mul_tern_sparse2_part_ptr)(uint16_t *z, const uint16_t *u, \
+  const uint16_t *w, const uint16_t *v, int vlen1, int vlen2, int lo, \
+  int hi, int N) = sparse2_part_first;
+void (*ring_mul_tern_sparse_wide_ptr)(uint16_t *z, const uint16_t *u, \
+  const uint16_t *v, int vlen, int N) = sparse_wide_first;
+void (*ring_mul_tern_sparse2_wide_ptr)(uint16_t *z, const uint16_t *u, \
+  const uint16_t *w, const uint16_t *v, int vlen1, int vlen2, int N) = \
+  sparse2_wide_first;
+void (*ring_mul_tern_sparse_multi_ptr)(uint16_t *z[], const uint16_t *u[], \
+  const uint16_t *start, int vlen, int num, int N) = multi_first;
+
+static const ring_kernel_t *ring_kernel_cur = NULL;
+
+
+// The functions <sparse_first>, <sparse2_first>, etc. select the kernel on the
+// first call through one of the pointers when this has not yet been done at
+// program start (e.g. because the compiler does not support constructors).
+
+static void sparse_first(uint16_t *r, const uint16_t *u, const uint16_t *v,
+                         int vlen, int N)
+{
+  ring_kernel_init();
+  ring_mul_tern_sparse_ptr(r, u, v, vlen, N);
+}
+
+static void sparse2_first(uint16_t *r, const uint16_t *u, const uint16_t *w,
+                          const uint16_t *v, int vlen1, int vlen2, int N)
+{
+  ring_kernel_init();
+  ring_mul_tern_sparse2_ptr(r, u, w, v, vlen1, vlen2, N);
+}
+
+static void sparse2_part_first(uint16_t *r, const uint16_t *u,
+                               const uint16_t *w, const uint16_t *v,
+                               int vlen1, int vlen2, int lo, int hi, int N)
+{
+  ring_kernel_init();
+  ring_mul_tern_sparse2_part_ptr(r, u, w, v, vlen1, vlen2, lo, hi, N);
+}
+
+static void sparse_wide_first(uint16_t *r, const uint16_t *u,
+                              const uint16_t *v, int vlen, int N)
+{
+  ring_kernel_init();
+  ring_mul_tern_sparse_wide_ptr(r, u, v, vlen, N);
+}
+
+static void sparse2_wide_first(uint16_t *r, const uint16_t *u,
+                               const uint16_t *w, const uint16_t *v,
+                               int vlen1, int vlen2, int N)
+{
+  ring_kernel_init();
+  ring_mul_tern_sparse2_wide_ptr(r, u, w, v, vlen1, vlen2, N);
+}
+
+static void multi_first(uint16_t *r[], const uint16_t *u[],
+                        const uint16_t *start, int vlen, int num, int N)
+{
+  ring_kernel_init();
+  ring_mul_tern_sparse_multi_ptr(r, u, start, vlen, num, N);
+}
+
+
+// The function <ring_kernel_num> returns the number of kernels in the registry
+// and <ring_kernel_get> the kernel with number <i> (or NULL when <i> is out of
+// range), which allows one to iterate over all kernels, e.g. for testing.
+
+int ring_kernel_num(void)
+{
+  return NUM_KERNELS;
+}
+
+const ring_kernel_t *ring_kernel_get(int i)
+{
+  return ((i >= 0) && (i < NUM_KERNELS)) ? &ring_kernels[i] : NULL;
+}
+
+
+// The function <ring_kernel_select> activates the kernel with name <name> if
+// it exists and is supported by the processor; otherwise (or when <name> is
+// NULL or empty) the first supported kernel of the registry is activated. The
+// function returns the activated kernel. It should not be called while other
+// threads perform a ring multiplication.
+
+const ring_kernel_t *ring_kernel_select(const char *name)
+{
+  const ring_kernel_t *k = NULL;
+  int i;
+
+#if defined(AVRNTRU_X86_TARGETS)
+  __builtin_cpu_init();
+#endif
+  if ((name != NULL) && (name[0] != '\0')) {
+    for (i = 0; i < NUM_KERNELS; i ++) {
+      if ((strcmp(ring_kernels[i].name, name) == 0) && \
+          ring_kernels[i].supported()) k = &ring_kernels[i];
+    }
+  }
+  for (i = 0; (k == NULL) && (i <= LAST_AUTO_KERNEL); i ++) {
+    if (ring_kernels[i].supported()) k = &ring_kernels[i];
+  }
+  ring_mul_tern_sparse_ptr = k->sparse;
+  ring_mul_tern_sparse2_ptr = k->sparse2;
+  ring_mul_tern_sparse2_part_ptr = k->sparse2_part;
+  ring_mul_tern_sparse_wide_ptr = k->sparse_wide;
+  ring_mul_tern_sparse2_wide_ptr = k->sparse2_wide;
+  ring_mul_tern_sparse_multi_ptr = k->multi;
+  ring_kernel_cur = k;
+
+  return k;
+}
+
+
+// The function <ring_kernel_active> returns the currently active kernel.
+
+const ring_kernel_t *ring_kernel_active(void)
+{
+  if (ring_kernel_cur == NULL) ring_kernel_init();
+  return ring_kernel_cur;
+}
+
+
+// The function <ring_kernel_init> activates the kernel given by the
+// environment variable AVRNTRU_KERNEL, or the first supported kernel when the
+// variable is not set. With gcc and compatible compilers it is automatically
+// executed at program start.
+
+#if defined(__GNUC__)
+__attribute__((constructor))
+#endif
+void ring_kernel_init(void)
+{
+  ring_kernel_select(getenv("AVRNTRU_KERNEL"));
+}
+
+#endif  // defined(AVRNTRU_DISPATCH)
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_dispatch.h: Run-Time Selection of the Ring Arithmetic Kernels.       //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_RING_DISPATCH_H
+#define AVRNTRU_RING_DISPATCH_H
+
+#include "typedefs.h"
+#include "config.h"
+#include "ring_arith.h"
+
+#if defined(AVRNTRU_DISPATCH)
+
+// Struct for an entry of the kernel registry, i.e. an implementation of the
+// sparse multiplication (ring_mul_tern_sparse) and of the sum of two sparse
+// multiplications (ring_mul_tern_sparse2), together with the version of the
+// latter for a range of coefficients (ring_mul_tern_sparse2_part), the "wide"
+// versions of both for operands with AVRNTRU_PUBKEY_PAD wrap-around elements
+// (ring_mul_tern_sparse_wide and ring_mul_tern_sparse2_wide), and the multi-
+// key multiplication (ring_mul_tern_sparse_multi). Kernels without a dedicated
+// version of one of these functions use the normal or the best C99 version
+// instead. The function <supported> returns 1 when the processor can execute
+// the kernel.
+
+typedef struct ring_kernel {
+  const char *name;           // name of the kernel, e.g. "avx2"
+  void (*sparse)(uint16_t *r, const uint16_t *u, const uint16_t *v, int vlen,
+                 int N);
+  void (*sparse2)(uint16_t *r, const uint16_t *u, const uint16_t *w,
+                  const uint16_t *v, int vlen1, int vlen2, int N);
+  void (*sparse2_part)(uint16_t *r, const uint16_t *u, const uint16_t *w,
+                       const uint16_t *v, int vlen1, int vlen2, int lo,
+                       int hi, int N);
+  void (*sparse_wide)(uint16_t *r, const uint16_t *u, const uint16_t *v,
+                      int vlen, int N);
+  void (*sparse2_wide)(uint16_t *r, const uint16_t *u, const uint16_t *w,
+                       const uint16_t *v, int vlen1, int vlen2, int N);
+  void (*multi)(uint16_t *r[], const uint16_t *u[], const uint16_t *start,
+                int vlen, int num, int N);
+  int (*supported)(void);     // checks whether the processor has the ISA
+} ring_kernel_t;
+
+// Function prototypes
+
+int ring_kernel_num(void);
+const ring_kernel_t *ring_kernel_get(int i);
+const ring_kernel_t *ring_kernel_select(const char *name);
+const ring_kernel_t *ring_kernel_active(void);
+void ring_kernel_init(void);
+
+#endif  // defined(AVRNTRU_DISPATCH)
+
+#endif  // AVRNTRU_RING_DISPATCH_H
@@ -0,0 +1,265 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_inv.c: Inversion in the NTRU Ring for Key Generation.                //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "config.h"
+#include "ring_arith.h"
+#include "ring_inv.h"
+
+
+// The macro INTMASK(x) converts an integer x to an "all-1" mask when x = 1 and
+// to an "all-0" mask when x = 0.
+
+#define INTMASK(x) (~((x) - 1))
+
+
+// The following preprocessor directives define the length of the local arrays
+// in the inversion, namely the bit-sliced polynomials in ring_inv_mod2 (array
+// length <_plen>), the double-length product in poly2_mul (<_clen>), and the
+// arrays <c>, <t> in ring_inv_prodform. Depending on AVRNTRU_USE_VLA,
+// these arrays become either Variable-Length Arrays (VLAs) or static arrays
+// (see config.h for further information).
+
+#ifdef AVRNTRU_USE_VLA
+// Microsoft Visual C does not support VLAs
+#if !(defined(_MSC_VER) && !defined(__ICL))
+#define _plen POLY2_WORDS(N)
+#define _clen (2*POLY2_WORDS(N) + 8)
+#define _tlen (N + 7)
+#else  // static arrays are used
+#define _plen POLY2_WORDS(AVRNTRU_MAX_DIM)
+#define _clen (2*POLY2_WORDS(AVRNTRU_MAX_DIM) + 8)
+#define _tlen (AVRNTRU_MAX_DIM + 7)
+#endif
+#endif
+
+
+// The function <poly2_mul> multiplies two polynomials a(x) and b(x) over GF(2)
+// modulo x^N - 1. Both operands and the product r(x) are "bit-sliced", i.e. an
+// array of POLY2_WORDS(N) 32-bit words holds the N coefficients, whereby bit
+// k of word i is the coefficient of x^(32*i+k) and the bits beyond x^(N-1) are
+// 0. The multiplication uses the comb method: for each shift-distance s, the
+// operand b(x)*x^s is computed once and then added (XOR) to the product for
+// every word i of a(x) with bit s set, which is realized with a mask instead
+// of a branch so that the execution time does not depend on a(x). The words of
+// bs(x) are processed in blocks of eight (bs(x) is padded with 0-words), which
+// allows a compiler to vectorize the inner loop. Finally, the upper half of
+// the double-length product is folded onto the lower half (this is the
+// reduction modulo x^N - 1). The array <r> may overlap with <a> and/or
+// <b> since the product is only written to <r> after all words were read.
+
+static void poly2_mul(uint32_t *r, const uint32_t *a, const uint32_t *b,
+                      int N)
+{
+  int i, j, k, s, w = POLY2_WORDS(N), sh = N & 31;
+  uint32_t c[_clen], bs[_plen + 8], mask;
+
+  for (i = 2*w + 7; i >= 0; i--) c[i] = 0;
+  for (s = 0; s < 32; s ++) {
+    // bs(x) = b(x)*x^s (one word longer than b(x))
+    bs[0] = b[0] << s;
+    for (j = 1; j < w; j ++) bs[j] = (b[j] << s) | ((b[j-1] >> 1) >> (31-s));
+    bs[w] = (b[w-1] >> 1) >> (31-s);
+    for (j = w + 1; j < ((w + 8) & (-8)); j ++) bs[j] = 0;
+    // c(x) = c(x) + bs(x)*x^(32*i) for each word i of a(x) with bit s set
+    for (i = 0; i < w; i ++) {
+      mask = INTMASK((a[i] >> s) & 1);
+      for (j = 0; j <= w; j += 8)
+        for (k = 0; k < 8; k ++) c[i+j+k] ^= bs[j+k] & mask;
+    }
+  }
+  // reduction: r(x) = c(x) mod x^N - 1, i.e. fold the bits from x^N upwards
+  for (i = 0, j = N >> 5; i < w; i ++, j ++)
+    r[i] = c[i] ^ (c[j] >> sh) ^ ((c[j+1] << 1) << (31-sh));
+  r[w-1] &= 0xFFFFFFFFUL >> (32*w - N);
+}
+
+
+// The function <poly2_frob> raises a bit-sliced polynomial a(x) over GF(2) to
+// the power of 2^k modulo x^N - 1, whereby the argument <e> must be 2^k mod N.
+// Since squaring is linear in characteristic 2 (Frobenius endomorphism), this
+// power is simply r(x) = a(x^e) mod x^N - 1, i.e. the coefficient of x^i is
+// moved to x^(i*e mod N). The sequence of accessed bits depends only on the
+// public values <N> and <e>. Array <r> must not overlap with array <a>.
+
+static void poly2_frob(uint32_t *r, const uint32_t *a, int e, int N)
+{
+  int i, j, w = POLY2_WORDS(N);
+
+  for (i = w - 1; i >= 0; i--) r[i] = 0;
+  for (i = j = 0; i < N; i ++) {
+    r[j >> 5] |= ((a[i >> 5] >> (i & 31)) & 1) << (j & 31);
+    j += e; if (j >= N) j -= N;
+  }
+}
+
+
+// The function <pow2_mod> returns 2^k mod N. The exponent <k> and the modulus
+// <N> are public, which means the execution time does not need to be constant.
+
+static int pow2_mod(int k, int N)
+{
+  int e = 1;
+
+  for (; k > 0; k--) { e <<= 1; if (e >= N) e -= N; }
+
+  return e;
+}
+
+
+// The function <ring_mul_dense> multiplies two "dense" ring-elements a(x) and
+// b(x) using the schoolbook method. The array <a> contains the N coefficients
+// of a(x), whereas the array <b> consists of N+7 elements with b[N+i] = b[i]
+// for 0 <= i < 7 (like the operand of the sparse multiplication). The product
+// is written to array <r>, whose length is the smallest multiple of eight that
+// is greater than or equal to <N>; it must not overlap with <a> or <b>. The
+// coefficients are neither reduced modulo q nor need the operands to be
+// reduced (the 16-bit arithmetic is correct modulo q, see config.h). Like the
+// sparse multiplication, it uses the hybrid method, i.e. eight coefficients of
+// r(x) are kept in registers (resp. a vector register on x86, as the compiler
+// vectorizes the eight accumulations of the inner loop), whereby the loop over
+// the coefficients of a(x) is split so that no index wraps around. This
+// function is only used for the Newton iteration in <ring_inv_prodform>.
+
+static void ring_mul_dense(uint16_t *r, const uint16_t *a, const uint16_t *b,
+                           int N)
+{
+  int i, j, k;
+  uint16_t sum[8], c;
+  const uint16_t *bp;
+
+  for (k = 0; k < N; k += 8) {
+    for (j = 0; j < 8; j ++) sum[j] = 0;
+    // coefficients a_i with i <= k: b(x) starts at index k - i
+    for (i = 0; i <= k; i ++) {
+      c = a[i];
+      bp = &b[k-i];
+      for (j = 0; j < 8; j ++) sum[j] += (uint32_t) c*bp[j];
+    }
+    // coefficients a_i with i > k: b(x) starts at index N + k - i
+    for (; i < N; i ++) {
+      c = a[i];
+      bp = &b[N+k-i];
+      for (j = 0; j < 8; j ++) sum[j] += (uint32_t) c*bp[j];
+    }
+    for (j = 0; j < 8; j ++) r[k+j] = sum[j];
+  }
+}
+
+
+// The function <ring_inv_mod2> computes the inverse of a ring-element a(x)
+// modulo 2, i.e. the polynomial r(x) with a(x)*r(x) = 1 mod (2, x^N - 1). The
+// array <a> contains the N coefficients of a(x), of which only the least-
+// significant bit is used, and the N coefficients of r(x) (each either 0 or 1)
+// are written to array <r>. The inversion is carried out on bit-sliced
+// polynomials (see poly2_mul) and uses a constant-time exponentiation instead
+// of an extended Euclidean algorithm. For a prime N, the polynomial x^N - 1
+// splits over GF(2) into x - 1 and (N-1)/d irreducible factors of degree d,
+// where d is the multiplicative order of 2 modulo N. Consequently, the ring is
+// a product of the fields GF(2) and GF(2^d), and a unit a(x) satisfies a(x)^-1
+// = a(x)^(2^d - 2). This power is computed with the Itoh-Tsujii addition
+// chain for b_k(x) = a(x)^(2^k - 1), which needs about 2*log2(d) products
+// (e.g. 12 for N = 743) and the same number of cheap Frobenius powers. When
+// a(x) is not invertible, r(x) is meaningless and AVRNTRU_ERR_INVERT is
+// returned; this is checked via a(x)*r(x) = 1 at the end. The execution time
+// does not depend on the value of a(x), only on N.
+
+int ring_inv_mod2(uint16_t *r, const uint16_t *a, int N)
+{
+  int i, k, s, d, w = POLY2_WORDS(N);
+  uint32_t f[_plen], b[_plen], t[_plen], err;
+
+  // conversion of a(x) mod 2 to a bit-sliced polynomial f(x)
+  for (i = w - 1; i >= 0; i--) f[i] = 0;
+  for (i = 0; i < N; i ++) f[i >> 5] |= ((uint32_t) (a[i] & 1)) << (i & 31);
+  // multiplicative order d of 2 modulo N
+  for (d = 1, k = 2; k != 1; d ++) k = (2*k) % N;
+  // find the most-significant bit of d-1
+  for (s = 0; ((d - 1) >> s) > 1; s ++);
+  // Itoh-Tsujii: b(x) = f(x)^(2^k - 1) for k = 1, ..., d-1 (binary method)
+  for (i = 0; i < w; i ++) b[i] = f[i];
+  for (k = 1, s--; s >= 0; s--) {
+    poly2_frob(t, b, pow2_mod(k, N), N);
+    poly2_mul(b, t, b, N);
+    k = 2*k;
+    if (((d - 1) >> s) & 1) {
+      poly2_frob(t, b, 2, N);
+      poly2_mul(b, t, f, N);
+      k = k + 1;
+    }
+  }
+  // inverse t(x) = b(x)^2 = f(x)^(2^d - 2)
+  poly2_frob(t, b, 2, N);
+  // check whether f(x)*t(x) = 1
+  poly2_mul(b, t, f, N);
+  err = b[0] ^ 1;
+  for (i = 1; i < w; i ++) err |= b[i];
+  // conversion of t(x) to an array of coefficients
+  for (i = 0; i < N; i ++) r[i] = (t[i >> 5] >> (i & 31)) & 1;
+
+  return err ? AVRNTRU_ERR_INVERT : AVRNTRU_NO_ERROR;
+}
+
+
+// The function <ring_inv_prodform> computes the inverse of a private key f(x)
+// = 1 + 3*F(x) modulo q, whereby F(x) is a product-form polynomial given by
+// the struct <F>. The N coefficients of f^-1(x) are written to array <r>,
+// which must consist of N+7 elements, followed by seven wrap-around elements
+// r[N+i] = r[i] so that it can directly be used as an operand of the sparse
+// multiplication (see ntru_keygen). First, the inverse modulo 2 is computed
+// by <ring_inv_mod2>, which is then lifted to the inverse modulo q = 2^k via
+// the Newton iteration r(x) = r(x)*(2 - f(x)*r(x)), which doubles the number
+// of correct bits in each iteration (i.e. four iterations for q = 2048). The
+// product f(x)*r(x) = r(x) + 3*F(x)*r(x) is obtained with the product-form
+// multiplication, whereas the second product requires a multiplication of two
+// dense ring-elements. The array <r> serves as accumulator of the iteration,
+// so that only two temporary arrays of N+7 elements are needed (about 3 kB on
+// AVR for N = 743). When f(x) is not invertible, AVRNTRU_ERR_INVERT is
+// returned and a new F(x) has to be chosen.
+
+int ring_inv_prodform(uint16_t *r, const prod_form_poly_t *F, int N)
+{
+  int i, k, err;
+  uint16_t c[_tlen], t[_tlen];
+
+  // t(x) = F(x) as dense ring-element via the multiplication F(x)*1
+  for (i = N + 6; i > 0; i--) c[i] = 0;
+  c[0] = c[N] = 1;
+  ring_mul_tern_prodform(t, c, F, N);
+  // f(x) = 1 + 3*F(x) and its inverse r(x) modulo 2
+  for (i = 0; i < N; i ++) t[i] = 3*t[i];
+  t[0] += 1;
+  err = ring_inv_mod2(r, t, N);
+  // Newton iteration: r(x) is the inverse modulo 2^(2*k) after each step
+  for (k = 1; k < AVRNTRU_LOG_Q; k *= 2) {
+    for (i = 0; i < 7; i ++) r[N+i] = r[i];
+    // c(x) = 2 - f(x)*r(x) = 2 - r(x) - 3*F(x)*r(x)
+    ring_mul_tern_prodform(t, r, F, N);
+    for (i = 0; i < N; i ++) c[i] = -(r[i] + 3*t[i]);
+    c[0] += 2;
+    for (i = 0; i < 7; i ++) c[N+i] = c[i];
+    // r(x) = r(x)*c(x)
+    ring_mul_dense(t, r, c, N);
+    for (i = 0; i < N; i ++) r[i] = t[i];
+  }
+  for (i = 0; i < N; i ++) r[i] &= AVRNTRU_Q_MASK;
+  for (i = 0; i < 7; i ++) r[N+i] = r[i];
+
+  return err;
+}
@@ -0,0 +1,37 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_inv.h: Inversion in the NTRU Ring for Key Generation.                //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_RING_INV_H
+#define AVRNTRU_RING_INV_H
+
+#include "typedefs.h"
+#include "config.h"
+#include "ring_arith.h"
+
+// Number of 32-bit words of a bit-sliced polynomial over GF(2) with <N>
+// coefficients (one bit per coefficient, see ring_inv.c).
+
+#define POLY2_WORDS(N) (((N) + 31) >> 5)
+
+// Function prototypes
+
+int ring_inv_mod2(uint16_t *r, const uint16_t *a, int N);
+int ring_inv_prodform(uint16_t *r, const prod_form_poly_t *F, int N);
+
+#endif  // AVRNTRU_RING_INV_H
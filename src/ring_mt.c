@@ -0,0 +1,286 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_mt.c: Multi-Threaded Polynomial Arithmetic for the NTRU Ring.        //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "config.h"
+#include "ring_mt.h"
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+
+#include <unistd.h>  // sysconf
+
+// Number of times an idle worker polls the generation number of the pool for
+// a new job before it goes to sleep, and number of times the calling thread
+// polls the counter of finished workers before it goes to sleep. A job that is
+// published (resp. finished) while the other side is still polling needs no
+// system call. The macro CPU_RELAX is used inside busy-wait loops to reduce
+// the power consumption of the polling (and the penalty when leaving the
+// loop) on x86 processors.
+
+#define RING_POOL_SPIN 100000
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CPU_RELAX() ((void) 0)
+#endif
+
+
+// The following preprocessor directives define the length of the local array
+// <t> in ring_mul_tern_prodform_mt (see the corresponding definition in
+// ring_arith.c).
+
+#ifdef AVRNTRU_USE_VLA
+#define _tlen (N + 7)
+#else  // static arrays are used
+#define _tlen (AVRNTRU_MAX_DIM + 7)
+#endif
+
+
+// The function <ring_pool_wait> is executed by a worker to wait for a job with
+// a generation number different from <seen>, which is returned. The worker
+// first polls the generation number and, when no job is published during
+// RING_POOL_SPIN iterations, it sleeps on the condition variable of the pool.
+// Both the counter <sleepers> and the generation number are accessed with
+// sequentially-consistent atomics, which guarantees that either the worker
+// sees the new generation number or the publishing thread sees the worker as
+// sleeper (and signals the condition variable).
+
+static int ring_pool_wait(ring_pool_t *pool, int seen)
+{
+  int i, gen;
+
+  for (i = 0; i < RING_POOL_SPIN; i ++) {
+    gen = __atomic_load_n(&pool->gen, __ATOMIC_ACQUIRE);
+    if (gen != seen) return gen;
+    CPU_RELAX();
+  }
+  pthread_mutex_lock(&pool->lock);
+  __atomic_fetch_add(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+  while ((gen = __atomic_load_n(&pool->gen, __ATOMIC_SEQ_CST)) == seen)
+    pthread_cond_wait(&pool->wake, &pool->lock);
+  __atomic_fetch_sub(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&pool->lock);
+
+  return gen;
+}
+
+
+// The function <ring_pool_main> is the main loop of the worker threads. Each
+// job is executed once by every worker, which passes its number and the total
+// number of threads to the job-function so that the latter can determine the
+// share of the work to be done by the worker. A worker that finishes a job
+// while the calling thread sleeps (see <ring_pool_run>) signals the condition
+// variable <finish>.
+
+static void *ring_pool_main(void *arg)
+{
+  ring_pool_worker_t *worker = (ring_pool_worker_t *) arg;
+  ring_pool_t *pool = worker->pool;
+  int seen = 0;
+
+  for (;;) {
+    seen = ring_pool_wait(pool, seen);
+    if (__atomic_load_n(&pool->quit, __ATOMIC_ACQUIRE)) break;
+    pool->func(pool->arg, worker->id, pool->num_threads);
+    __atomic_fetch_add(&pool->done, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->waiting, __ATOMIC_SEQ_CST)) {
+      pthread_mutex_lock(&pool->lock);
+      pthread_cond_signal(&pool->finish);
+      pthread_mutex_unlock(&pool->lock);
+    }
+  }
+
+  return NULL;
+}
+
+
+// The function <ring_pool_publish> starts a new job (or the termination of
+// the workers when <quit> has been set) by incrementing the generation number,
+// and wakes up the workers that went to sleep in the meantime.
+
+static void ring_pool_publish(ring_pool_t *pool)
+{
+  __atomic_fetch_add(&pool->gen, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&pool->sleepers, __ATOMIC_SEQ_CST) > 0) {
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+  }
+}
+
+
+// The function <ring_pool_init> initializes a pool of <num_threads> threads,
+// i.e. it starts num_threads-1 workers (the calling thread is thread 0 of each
+// job). The value of <num_threads> is clipped to [1, AVRNTRU_MAX_THREADS] and
+// to the number of online processors, since more threads than processors
+// would only compete for the same cores (and a polling thread could delay
+// the thread that does the actual work). The workers persist until
+// <ring_pool_free> is called, so the cost for starting them is paid only once.
+// AVRNTRU_ERR_THREAD is returned (and no thread is running) when a worker
+// could not be started.
+
+int ring_pool_init(ring_pool_t *pool, int num_threads)
+{
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  int i;
+
+  if (num_threads > AVRNTRU_MAX_THREADS) num_threads = AVRNTRU_MAX_THREADS;
+  if ((cpus > 0) && (num_threads > cpus)) num_threads = (int) cpus;
+  if (num_threads < 1) num_threads = 1;
+  pool->func = NULL;
+  pool->arg = NULL;
+  pool->gen = pool->done = pool->sleepers = pool->waiting = pool->quit = 0;
+  pool->num_threads = num_threads;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->wake, NULL);
+  pthread_cond_init(&pool->finish, NULL);
+
+  for (i = 1; i < num_threads; i ++) {
+    pool->worker[i].pool = pool;
+    pool->worker[i].id = i;
+    if (pthread_create(&pool->thread[i], NULL, ring_pool_main, \
+                       &pool->worker[i]) != 0) {
+      pool->num_threads = i;  // terminate the workers started so far
+      ring_pool_free(pool);
+      return AVRNTRU_ERR_THREAD;
+    }
+  }
+
+  return AVRNTRU_NO_ERROR;
+}
+
+
+// The function <ring_pool_free> terminates all workers of a pool and releases
+// its resources. The pool must not be used anymore afterwards.
+
+void ring_pool_free(ring_pool_t *pool)
+{
+  int i;
+
+  __atomic_store_n(&pool->quit, 1, __ATOMIC_RELEASE);
+  ring_pool_publish(pool);
+  for (i = 1; i < pool->num_threads; i ++) pthread_join(pool->thread[i], NULL);
+  pthread_cond_destroy(&pool->finish);
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->lock);
+}
+
+
+// The function <ring_pool_run> executes the job-function <func> on all threads
+// of the pool (including the calling thread, which gets the number 0) and
+// returns when every thread has finished. After its own share, the calling
+// thread polls the counter <done> for RING_POOL_SPIN iterations and then
+// sleeps on the condition variable <finish> (e.g. when a worker has been
+// descheduled), whereby the flag <waiting> plays the same role as <sleepers>
+// in <ring_pool_wait>. No lock is taken unless a thread is asleep, which only
+// happens when the pool was idle or a worker was delayed for a longer time.
+// Jobs must not be started concurrently from different threads.
+
+void ring_pool_run(ring_pool_t *pool, void (*func)(void *, int, int),
+                   void *arg)
+{
+  int i, num = pool->num_threads;
+
+  if (num == 1) {
+    func(arg, 0, 1);
+    return;
+  }
+  pool->func = func;
+  pool->arg = arg;
+  __atomic_store_n(&pool->done, 0, __ATOMIC_RELAXED);
+  ring_pool_publish(pool);
+  func(arg, 0, num);
+  for (i = 0; i < RING_POOL_SPIN; i ++) {
+    if (__atomic_load_n(&pool->done, __ATOMIC_ACQUIRE) == num - 1) return;
+    CPU_RELAX();
+  }
+  pthread_mutex_lock(&pool->lock);
+  __atomic_store_n(&pool->waiting, 1, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(&pool->done, __ATOMIC_SEQ_CST) != num - 1)
+    pthread_cond_wait(&pool->finish, &pool->lock);
+  __atomic_store_n(&pool->waiting, 0, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+
+// Arguments of the two jobs of the multi-threaded product-form multiplication.
+// In the 1st job, thread k computes its share of t(x) = a(x)*b1(x), and in the
+// 2nd job its share of r(x) = t(x)*b2(x) + a(x)*b3(x) mod q.
+
+typedef struct prodform_job {
+  uint16_t *r;                // result-array of the job
+  const uint16_t *u;          // operand multiplied by the 1st sparse poly
+  const uint16_t *w;          // operand multiplied by the 2nd sparse poly
+  const uint16_t *v;          // indices of the non-0 coeffs of both polys
+  int vlen1, vlen2;           // number of non-0 coeffs of both polys
+  int N;                      // dimension of the ring
+} prodform_job_t;
+
+
+// The job-function <prodform_job_main> splits the ceil(N/8) blocks of eight
+// coefficients of the result into <num> contiguous ranges of (almost) equal
+// size and computes the range of thread <id>. The threads write to disjoint
+// parts of the result-array and only read the shared operands, i.e. no
+// synchronization is needed within a job.
+
+static void prodform_job_main(void *arg, int id, int num)
+{
+  prodform_job_t *job = (prodform_job_t *) arg;
+  int N = job->N, nblk = (N + 7) >> 3;
+  int lo = ((id*nblk)/num) << 3, hi = (((id + 1)*nblk)/num) << 3;
+
+  if (hi > N) hi = N;
+  if (lo >= hi) return;
+  ring_mul_tern_sparse2_part(job->r, job->u, job->w, job->v, job->vlen1, \
+                             job->vlen2, lo, hi, N);
+}
+
+
+// The function <ring_mul_tern_prodform_mt> computes the same product as the
+// function <ring_mul_tern_prodform>, i.e. r(x) = a(x)*b(x) mod q, where b(x)
+// is a product-form polynomial, and the arrays <r> and <a> have the same
+// format as there. The coefficients of the products are distributed among the
+// threads of the pool <pool>, whereby each thread computes a contiguous range
+// of blocks of eight coefficients with <ring_mul_tern_sparse2_part> (i.e. the
+// same vectorized or dispatched kernel as the single-threaded version). Two
+// jobs are needed since the 2nd multiplication requires all coefficients of
+// t(x) = a(x)*b1(x); the wrap-around elements of t(x) are set by the calling
+// thread in between.
+
+void ring_mul_tern_prodform_mt(ring_pool_t *pool, uint16_t *r,
+                               const uint16_t *a, const prod_form_poly_t *b,
+                               int N)
+{
+  int i;
+  uint16_t t[_tlen];
+  prodform_job_t job;
+
+  // 1st job: t(x) = a(x)*b1(x) mod q
+  job.r = t; job.u = a; job.w = NULL; job.v = b->indices;
+  job.vlen1 = b->num_nzc_poly1; job.vlen2 = 0; job.N = N;
+  ring_pool_run(pool, prodform_job_main, &job);
+  for (i = 6; i >= 0; i--) t[N+i] = t[i];
+  // 2nd job: r(x) = t(x)*b2(x) + a(x)*b3(x) mod q
+  job.r = r; job.u = t; job.w = a; job.v = &(b->indices[b->num_nzc_poly1]);
+  job.vlen1 = b->num_nzc_poly2; job.vlen2 = b->num_nzc_poly3;
+  ring_pool_run(pool, prodform_job_main, &job);
+}
+
+#endif  // defined(AVRNTRU_USE_THREADS) && ...
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_mt.h: Multi-Threaded Polynomial Arithmetic for the NTRU Ring.        //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_RING_MT_H
+#define AVRNTRU_RING_MT_H
+
+#include "typedefs.h"
+#include "config.h"
+#include "ring_arith.h"
+
+#if defined(AVRNTRU_USE_THREADS) && !defined(__AVR__)
+
+#include <pthread.h>
+
+// Struct for a pool of persistent worker threads. The calling thread takes
+// part in every job as thread 0, so a pool of <num_threads> threads contains
+// num_threads-1 workers. A job is published by incrementing <gen>, which the
+// workers poll for a while before they go to sleep on the condition variable
+// <wake>; the completion of a job is signalled through the counter <done> (and
+// the condition variable <finish> when the calling thread sleeps). The
+// members should be considered private and are only accessed via the atomic
+// built-ins of the compiler or while holding <lock>.
+
+struct ring_pool;
+
+typedef struct ring_pool_worker {
+  struct ring_pool *pool;     // pool to which the worker belongs
+  int id;                     // number of the worker in [1, num_threads-1]
+} ring_pool_worker_t;
+
+typedef struct ring_pool {
+  pthread_t thread[AVRNTRU_MAX_THREADS];
+  ring_pool_worker_t worker[AVRNTRU_MAX_THREADS];
+  pthread_mutex_t lock;       // only used to put idle threads to sleep
+  pthread_cond_t wake;        // signalled when a job is published to sleepers
+  pthread_cond_t finish;      // signalled when a job is finished to caller
+  void (*func)(void *arg, int id, int num);  // function of the current job
+  void *arg;                  // argument of the current job
+  int gen;                    // generation number of the current job
+  int done;                   // number of workers that finished the job
+  int sleepers;               // number of workers waiting on <wake>
+  int waiting;                // set to 1 while the caller waits on <finish>
+  int quit;                   // set to 1 to terminate all workers
+  int num_threads;            // number of threads including the caller
+} ring_pool_t;
+
+// Function prototypes
+
+int ring_pool_init(ring_pool_t *pool, int num_threads);
+void ring_pool_free(ring_pool_t *pool);
+void ring_pool_run(ring_pool_t *pool, void (*func)(void *, int, int),
+                   void *arg);
+void ring_mul_tern_prodform_mt(ring_pool_t *pool, uint16_t *r,
+                               const uint16_t *a, const prod_form_poly_t *b,
+                               int N);
+
+#endif  // defined(AVRNTRU_USE_THREADS) && ...
+
+#endif  // AVRNTRU_RING_MT_H
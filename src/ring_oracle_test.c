@@ -0,0 +1,633 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_oracle_test.c: Differential Tests against Schoolbook Multiplication. //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+// This program checks every implementation of the multiplication of a ring-
+// element by a sparse ternary polynomial and by a product-form polynomial
+// against an "oracle", namely a naive schoolbook multiplication modulo x^N - 1
+// that does not exploit the sparseness of the ternary operand. It runs a
+// differential test of each function with random operands for dimensions
+// from 11 to 743 (including dimensions that are a multiple of 8, 16, and 32
+// plus or minus 1), numbers of non-0 coefficients from 1 to AVRNTRU_MAX_NZC
+// (including odd ones), and four kinds of sparse polynomials: random indices,
+// random indices including 0 and N-1, and runs of consecutive indices at the
+// beginning and at the end of the polynomial, which cause the maximum number
+// of wrap-arounds. The elements beyond the wrap-around elements expected by a
+// function are filled with garbage, i.e. a function that reads too far gives
+// a wrong result. When the kernel registry is available, the sparse products
+// are taken from there, so that every kernel the processor supports is tested.
+// Finally, the program prints the execution time of every function for the
+// dimension of EES743EP1 together with its speedup over the oracle in JSON
+// format, e.g. {"kernel":"ring_mul_tern_sparse_avx2","N":743,"vlen":30,
+// "cycles":6506,"oracle":1301044,"speedup":200.0,"unit":"cycles"}. The exit
+// status is 1 if any function disagrees with the oracle:
+//
+// gcc -std=c99 -O2 -mavx2 -o oracle ring_oracle_test.c ring_arith.c
+//     ring_dispatch.c ring_tern.c utils.c
+// ./oracle
+
+#if defined(__linux__)
+#define _GNU_SOURCE  // clock_gettime
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define ORACLE_UNIT "cycles"
+#else
+#define ORACLE_UNIT "ns"
+#endif
+#include "config.h"
+#include "ring_arith.h"
+#include "ring_tern.h"
+#include "ring_mt.h"
+#include "ring_dispatch.h"
+
+#ifdef __AVR__
+#error "ring_oracle_test.c is a host program (see ring_arith_test.c for AVR)"
+#endif
+
+#define ORACLE_NUM 3        // number of products of the batch functions
+#define ORACLE_RUNS 25      // number of runs of which the minimum is taken
+#define ORACLE_WIDE_PAD 15  // wrap-around elements of the "wide" AVX2 version
+#define ORACLE_LEN (AVRNTRU_MAX_DIM + 16)           // length of operands
+#define ORACLE_RLEN ((AVRNTRU_MAX_DIM + 15) & -16)  // length of results
+
+// Type of the tested function, which determines how it is called and what the
+// oracle computes (see oracle_check)
+
+enum { ORACLE_SPARSE, ORACLE_SPARSE2, ORACLE_MOD3, ORACLE_MULTI,
+       ORACLE_PRODFORM, ORACLE_PF_MOD3, ORACLE_PF_MULTI, ORACLE_TERN };
+
+typedef struct oracle_func {
+  const char *name;
+  int type;
+  int pad;                    // number of wrap-around elements of operands
+  void (*sparse)(uint16_t *r, const uint16_t *u, const uint16_t *v, int vlen,
+                 int N);
+  void (*sparse2)(uint16_t *r, const uint16_t *u, const uint16_t *w,
+                  const uint16_t *v, int vlen1, int vlen2, int N);
+  void (*multi)(uint16_t *r[], const uint16_t *u[], const uint16_t *start,
+                int vlen, int num, int N);
+  void (*prodform)(uint16_t *r, const uint16_t *a, const prod_form_poly_t *b,
+                   int N);
+  int (*supported)(void);     // NULL if the function is always supported
+} oracle_func_t;
+
+
+#if defined(AVRNTRU_X86_TARGETS) && !defined(__AVX2__)
+static int cpu_avx2(void)
+{
+  return __builtin_cpu_supports("avx2") != 0;
+}
+#else
+#define cpu_avx2 NULL
+#endif
+
+#ifdef AVRNTRU_USE_THREADS
+
+static ring_pool_t oracle_pool;
+
+static void oracle_prodform_mt(uint16_t *r, const uint16_t *a,
+                               const prod_form_poly_t *b, int N)
+{
+  ring_mul_tern_prodform_mt(&oracle_pool, r, a, b, N);
+}
+
+#endif
+
+// Functions tested on the host. When the kernel registry is available, the
+// sparse multiplications and the sums of two sparse multiplications are taken
+// from there instead (see oracle_collect).
+
+static const oracle_func_t oracle_funcs[] = {
+#if !defined(AVRNTRU_DISPATCH)
+  { "ring_mul_tern_sparse_c99", ORACLE_SPARSE, 7, \
+    ring_mul_tern_sparse_c99, NULL, NULL, NULL, NULL },
+  { "ring_mul_tern_sparse_V2", ORACLE_SPARSE, 7, \
+    ring_mul_tern_sparse_V2, NULL, NULL, NULL, NULL },
+  { "ring_mul_tern_sparse_swar", ORACLE_SPARSE, 7, \
+    ring_mul_tern_sparse_swar, NULL, NULL, NULL, NULL },
+#if defined(AVRNTRU_SPECIALIZE)
+  { "ring_mul_tern_sparse_spec", ORACLE_SPARSE, 7, \
+    ring_mul_tern_sparse_spec, NULL, NULL, NULL, NULL },
+  { "ring_mul_tern_sparse2_spec", ORACLE_SPARSE2, 7, \
+    NULL, ring_mul_tern_sparse2_spec, NULL, NULL, NULL },
+#endif
+#if defined(__SSE2__)
+  { "ring_mul_tern_sparse_sse2", ORACLE_SPARSE, 7, \
+    ring_mul_tern_sparse_sse2, NULL, NULL, NULL, NULL },
+#endif
+#if defined(__AVX2__)
+  { "ring_mul_tern_sparse_avx2", ORACLE_SPARSE, 7, \
+    ring_mul_tern_sparse_avx2, NULL, NULL, NULL, NULL },
+  { "ring_mul_tern_sparse2_avx2", ORACLE_SPARSE2, 7, \
+    NULL, ring_mul_tern_sparse2_avx2, NULL, NULL, NULL },
+#endif
+#if defined(__AVX512BW__)
+  { "ring_mul_tern_sparse_avx512", ORACLE_SPARSE, 7, \
+    ring_mul_tern_sparse_avx512, NULL, NULL, NULL, NULL },
+#endif
+  { "ring_mul_tern_sparse2_c99", ORACLE_SPARSE2, 7, \
+    NULL, ring_mul_tern_sparse2_c99, NULL, NULL, NULL },
+#endif  // !defined(AVRNTRU_DISPATCH)
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+  { "ring_mul_tern_sparse_wide_avx2", ORACLE_SPARSE, ORACLE_WIDE_PAD, \
+    ring_mul_tern_sparse_wide_avx2, NULL, NULL, NULL, cpu_avx2 },
+  { "ring_mul_tern_sparse2_wide_avx2", ORACLE_SPARSE2, ORACLE_WIDE_PAD, \
+    NULL, ring_mul_tern_sparse2_wide_avx2, NULL, NULL, cpu_avx2 },
+  { "ring_mul_tern_sparse_multi_avx2", ORACLE_MULTI, 7, \
+    NULL, NULL, ring_mul_tern_sparse_multi_avx2, NULL, cpu_avx2 },
+#endif
+  { "ring_mul_tern_sparse_multi_c99", ORACLE_MULTI, 7, \
+    NULL, NULL, ring_mul_tern_sparse_multi_c99, NULL, NULL },
+  { "ring_mul_tern_sparse_mod3_c99", ORACLE_MOD3, 7, \
+    ring_mul_tern_sparse_mod3_c99, NULL, NULL, NULL, NULL },
+  { "ring_mul_tern_prodform", ORACLE_PRODFORM, 7, \
+    NULL, NULL, NULL, ring_mul_tern_prodform, NULL },
+  { "ring_mul_tern_prodform_wide", ORACLE_PRODFORM, AVRNTRU_PUBKEY_PAD, \
+    NULL, NULL, NULL, ring_mul_tern_prodform_wide, NULL },
+  { "ring_mul_tern_prodform_mod3", ORACLE_PF_MOD3, 7, \
+    NULL, NULL, NULL, ring_mul_tern_prodform_mod3, NULL },
+  { "ring_mul_tern_prodform_multi", ORACLE_PF_MULTI, 7, \
+    NULL, NULL, NULL, NULL, NULL },
+#ifdef AVRNTRU_USE_THREADS
+  { "ring_mul_tern_prodform_mt", ORACLE_PRODFORM, 7, \
+    NULL, NULL, NULL, oracle_prodform_mt, NULL },
+#endif
+  { "ring_tern_mul_sparse", ORACLE_TERN, 0, \
+    NULL, NULL, NULL, NULL, NULL }
+};
+
+// Operands and results of the tested functions and of the oracle. The arrays
+// <idx> hold the indices of up to three sparse polynomials (or the indices of
+// a product-form polynomial), and <start> the corresponding start-indices.
+
+static uint16_t u[ORACLE_NUM][ORACLE_LEN], w[ORACLE_LEN];
+static uint16_t r[ORACLE_NUM][ORACLE_RLEN], ref[ORACLE_NUM][ORACLE_RLEN];
+static uint16_t idx[ORACLE_NUM][3*AVRNTRU_MAX_NZC];
+static uint16_t start[3*AVRNTRU_MAX_NZC];
+static uint16_t d1[AVRNTRU_MAX_DIM], d2[AVRNTRU_MAX_DIM];
+static uint16_t d3[AVRNTRU_MAX_DIM];
+static uint32_t ta[RING_TERN_LEN(AVRNTRU_MAX_DIM)];
+static uint32_t tr[RING_TERN_LEN(AVRNTRU_MAX_DIM)];
+
+
+// Simple linear congruential generator to produce reproducible operands
+
+static uint32_t lcg_state = 1;
+
+static uint16_t lcg_next(void)
+{
+  lcg_state = lcg_state*1103515245UL + 12345UL;
+  return (uint16_t) (lcg_state >> 16);
+}
+
+
+// The function <oracle_time> returns the current value of the time-stamp
+// counter on x86 processors, and the monotonic time in nanoseconds otherwise
+// (see also bench_time in ring_arith_bench.c).
+
+static uint64_t oracle_time(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  uint64_t t;
+
+  _mm_lfence();
+  t = __rdtsc();
+  _mm_lfence();
+
+  return t;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t) ts.tv_sec*1000000000ULL + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+
+// The function <oracle_elem> generates a random ring-element a(x) whose 16-bit
+// coefficients are not reduced modulo q (all functions compute modulo 2^16 or
+// modulo q). The first <pad> elements after a_(N-1) are the wrap-around
+// elements a[N+i] = a[i], and the remaining elements of the array are garbage.
+
+static void oracle_elem(uint16_t *a, int N, int pad)
+{
+  int i;
+
+  for (i = 0; i < N; i ++) a[i] = lcg_next();
+  for (i = N; i < ORACLE_LEN; i ++) a[i] = lcg_next() | 1;
+  for (i = 0; i < pad; i ++) a[N+i] = a[i];
+}
+
+
+// The function <oracle_sparse> generates the indices of a sparse ternary
+// polynomial with <vlen> non-0 coefficients, whereby <mode> specifies the kind
+// of indices: 0 = random indices, 1 = random indices including 0 and N-1, 2 =
+// the indices N-vlen, ..., N-1, 3 = the indices 0, ..., vlen-1. The indices
+// are distinct, i.e. <vlen> must not be larger than <N>.
+
+static void oracle_sparse(uint16_t *v, int vlen, int N, int mode)
+{
+  int i, j;
+
+  for (i = 0; i < vlen; i ++) {
+    if (mode >= 2) {
+      v[i] = (mode == 2) ? N - vlen + i : i;
+      continue;
+    }
+    do {
+      v[i] = lcg_next() % N;
+      for (j = 0; (j < i) && (v[j] != v[i]); j ++);
+    } while (j < i);
+  }
+  // move 0 and N-1 to two random positions (or insert them there)
+  if ((mode == 1) && (vlen >= 2)) {
+    j = lcg_next() % vlen;
+    for (i = 0; (i < vlen) && (v[i] != 0); i ++);
+    v[i < vlen ? i : j] = v[j];
+    v[j] = 0;
+    j = (j + 1 + lcg_next() % (vlen - 1)) % vlen;
+    for (i = 0; (i < vlen) && (v[i] != N-1); i ++);
+    v[i < vlen ? i : j] = v[j];
+    v[j] = N - 1;
+  }
+}
+
+
+// The function <oracle_mul> is the oracle, i.e. a schoolbook multiplication
+// that computes r(x) = r(x) + a(x)*b(x) mod (x^N - 1) for two dense ring-
+// elements a(x) and b(x) with coefficients modulo 2^16.
+
+static void oracle_mul(uint16_t *r, const uint16_t *a, const uint16_t *b,
+                       int N)
+{
+  int i, j, k;
+
+  for (i = 0; i < N; i ++) {
+    for (j = 0, k = i; j < N; j ++, k ++) {
+      if (k == N) k = 0;
+      r[k] += (uint32_t) a[i]*b[j];
+    }
+  }
+}
+
+
+// The function <oracle_dense> converts a sparse ternary polynomial, given by
+// the indices of its <vlen> non-0 coefficients (the first vlen/2 are +1, the
+// others -1), into a dense polynomial with coefficients 0, 1, and 0xFFFF.
+
+static void oracle_dense(uint16_t *b, const uint16_t *v, int vlen, int N)
+{
+  int i;
+
+  for (i = 0; i < N; i ++) b[i] = 0;
+  for (i = 0; i < vlen; i ++) b[v[i]] += (i < vlen/2) ? 1 : 0xFFFF;
+}
+
+
+// The function <oracle_sp> computes r(x) = r(x) + a(x)*v(x) with the oracle.
+
+static void oracle_sp(uint16_t *r, const uint16_t *a, const uint16_t *v,
+                      int vlen, int N)
+{
+  oracle_dense(d1, v, vlen, N);
+  oracle_mul(r, a, d1, N);
+}
+
+
+// The function <oracle_pf> computes r(x) = a(x)*b(x) with the oracle, where
+// b(x) = b1(x)*b2(x) + b3(x) is a product-form polynomial, whereby the dense
+// polynomial b(x) is computed with the oracle as well.
+
+static void oracle_pf(uint16_t *r, const uint16_t *a, const uint16_t *v,
+                      const int vlen[3], int N)
+{
+  int i;
+
+  for (i = 0; i < N; i ++) r[i] = d2[i] = 0;
+  oracle_dense(d3, &v[0], vlen[0], N);
+  oracle_sp(d2, d3, &v[vlen[0]], vlen[1], N);
+  oracle_dense(d1, &v[vlen[0]+vlen[1]], vlen[2], N);
+  for (i = 0; i < N; i ++) d2[i] += d1[i];
+  oracle_mul(r, a, d2, N);
+}
+
+
+// The function <oracle_mod3> centers a coefficient modulo q and reduces it
+// modulo 3, whereby the result is 0, 1, or -1 (i.e. 0xFFFF).
+
+static uint16_t oracle_mod3(uint16_t c)
+{
+  int s = c & AVRNTRU_Q_MASK;
+
+  if (s >= (int) (AVRNTRU_Q/2)) s -= (int) AVRNTRU_Q;
+  s = ((s % 3) + 3) % 3;
+
+  return (s == 2) ? 0xFFFF : (uint16_t) s;
+}
+
+
+// The function <oracle_tern> generates a random ternary polynomial with
+// coefficients 0, 1, and -1 (i.e. 0xFFFF).
+
+static void oracle_tern(uint16_t *a, int N)
+{
+  int i;
+
+  for (i = 0; i < N; i ++) a[i] = (uint16_t) (lcg_next() % 3 - 1);
+}
+
+
+// The function <oracle_run> executes the function <of> once with the operands
+// in the global arrays, i.e. u[], w, idx[], and start (which is prepared from
+// idx[0]). It returns the number of products that were computed.
+
+static int oracle_run(const oracle_func_t *of, const int vlen[3], int N)
+{
+  uint16_t *rp[ORACLE_NUM];
+  const uint16_t *up[ORACLE_NUM];
+  prod_form_poly_t b;
+  prod_form_prep_t p;
+  int k;
+
+  for (k = 0; k < ORACLE_NUM; k ++) {
+    rp[k] = r[k]; up[k] = u[k];
+  }
+  b.indices = idx[0];
+  b.num_nzc_poly1 = vlen[0];
+  b.num_nzc_poly2 = vlen[1];
+  b.num_nzc_poly3 = vlen[2];
+  switch (of->type) {
+    case ORACLE_SPARSE: case ORACLE_MOD3:
+      of->sparse(r[0], u[0], idx[0], vlen[0], N);
+      return 1;
+    case ORACLE_SPARSE2:
+      of->sparse2(r[0], u[0], w, idx[0], vlen[0], vlen[1], N);
+      return 1;
+    case ORACLE_MULTI:
+      of->multi(rp, up, start, vlen[0], ORACLE_NUM, N);
+      return ORACLE_NUM;
+    case ORACLE_PRODFORM: case ORACLE_PF_MOD3:
+      of->prodform(r[0], u[0], &b, N);
+      return 1;
+    case ORACLE_PF_MULTI:
+      ring_prep_prodform(&p, start, &b, N);
+      ring_mul_tern_prodform_multi(rp, up, &p, ORACLE_NUM);
+      return ORACLE_NUM;
+    default:
+      ring_tern_mul_sparse(tr, ta, idx[0], vlen[0], N);
+      return 1;
+  }
+}
+
+
+// The function <oracle_check> tests the function <of> for the dimension <N>,
+// the numbers of non-0 coefficients <vlen> (vlen[0] for a sparse polynomial,
+// vlen[0] and vlen[1] for the sums of two products, and all three for a
+// product-form polynomial), and the kind of indices <mode>. The results are
+// initialized with garbage, so that the oracle also verifies whether the
+// function accumulates into the result or overwrites it. The return value is
+// 1 if the results differ from the oracle, and 0 otherwise.
+
+static int oracle_check(const oracle_func_t *of, const int vlen[3], int N,
+                        int mode)
+{
+  int i, k, num, err = 0, len = vlen[0] + vlen[1] + vlen[2];
+  uint16_t mask = 0xFFFF;
+
+  for (k = 0; k < ORACLE_NUM; k ++) {
+    oracle_elem(u[k], N, of->pad);
+    oracle_sparse(&idx[k][0], vlen[0], N, mode);
+    oracle_sparse(&idx[k][vlen[0]], vlen[1], N, mode);
+    oracle_sparse(&idx[k][vlen[0]+vlen[1]], vlen[2], N, mode);
+    for (i = 0; i < ORACLE_RLEN; i ++) r[k][i] = ref[k][i] = lcg_next();
+  }
+  oracle_elem(w, N, of->pad);
+  for (i = 0; i < len; i ++)
+    start[i] = (idx[0][i] == 0) ? 0 : N - idx[0][i];
+  if (of->type == ORACLE_TERN) {
+    oracle_tern(u[0], N);
+    oracle_tern(ref[0], N);
+    ring_tern_from_dense(ta, u[0], N);
+    ring_tern_from_dense(tr, ref[0], N);
+  }
+
+  num = oracle_run(of, vlen, N);
+  if (of->type == ORACLE_TERN) ring_tern_to_dense(r[0], tr, N);
+
+  switch (of->type) {
+    case ORACLE_SPARSE:
+      oracle_sp(ref[0], u[0], idx[0], vlen[0], N);
+      break;
+    case ORACLE_SPARSE2:
+      for (i = 0; i < N; i ++) ref[0][i] = 0;
+      oracle_sp(ref[0], u[0], &idx[0][0], vlen[0], N);
+      oracle_sp(ref[0], w, &idx[0][vlen[0]], vlen[1], N);
+      mask = AVRNTRU_Q_MASK;
+      break;
+    case ORACLE_MOD3:
+      oracle_sp(ref[0], u[0], idx[0], vlen[0], N);
+      for (i = 0; i < N; i ++)
+        ref[0][i] = oracle_mod3(u[0][i] + 3*ref[0][i]);
+      break;
+    case ORACLE_MULTI:
+      for (k = 0; k < num; k ++) oracle_sp(ref[k], u[k], idx[0], vlen[0], N);
+      break;
+    case ORACLE_PRODFORM:
+      oracle_pf(ref[0], u[0], idx[0], vlen, N);
+      mask = AVRNTRU_Q_MASK;
+      break;
+    case ORACLE_PF_MOD3:
+      oracle_pf(ref[0], u[0], idx[0], vlen, N);
+      for (i = 0; i < N; i ++)
+        ref[0][i] = oracle_mod3(u[0][i] + 3*ref[0][i]);
+      break;
+    case ORACLE_PF_MULTI:
+      for (k = 0; k < num; k ++) oracle_pf(ref[k], u[k], idx[0], vlen, N);
+      mask = AVRNTRU_Q_MASK;
+      break;
+    default:
+      oracle_sp(ref[0], u[0], idx[0], vlen[0], N);
+      for (i = 0; i < N; i ++) ref[0][i] = oracle_mod3(ref[0][i]);
+  }
+
+  for (k = 0; k < num; k ++)
+    for (i = 0; i < N; i ++) err |= ((r[k][i] ^ ref[k][i]) & mask) != 0;
+
+  return err;
+}
+
+
+// The function <oracle_speedup> measures the function <of> and the oracle for
+// the dimension and the numbers of non-0 coefficients of EES743EP1 and prints
+// the minimum execution time of ORACLE_RUNS runs per product and the speedup
+// over the oracle in JSON format. The oracle computes a sparse product with
+// one schoolbook multiplication, the sum of two sparse products with two, and
+// a product-form product with two (b1(x)*b2(x) and a(x)*b(x)).
+
+static void oracle_speedup(const oracle_func_t *of)
+{
+  const int N = 743, vlen[3] = { 22, 22, 30 }, vsp[3] = { 30, 0, 0 };
+  const int *vl = vlen;
+  uint64_t t0, t, tmin = ~0ULL, tref = ~0ULL;
+  int i, k, num = 1, prods = 2;
+
+  if ((of->type == ORACLE_SPARSE) || (of->type == ORACLE_MOD3) || \
+      (of->type == ORACLE_MULTI) || (of->type == ORACLE_TERN)) {
+    vl = vsp;
+    prods = 1;
+  }
+  for (k = 0; k < ORACLE_NUM; k ++) {
+    oracle_elem(u[k], N, ORACLE_WIDE_PAD);
+    oracle_sparse(&idx[k][0], vl[0], N, 0);
+    oracle_sparse(&idx[k][vl[0]], vl[1], N, 0);
+    oracle_sparse(&idx[k][vl[0]+vl[1]], vl[2], N, 0);
+  }
+  oracle_elem(w, N, ORACLE_WIDE_PAD);
+  for (i = 0; i < vl[0] + vl[1] + vl[2]; i ++)
+    start[i] = (idx[0][i] == 0) ? 0 : N - idx[0][i];
+  oracle_tern(ref[0], N);
+  ring_tern_from_dense(ta, ref[0], N);
+  ring_tern_from_dense(tr, ref[0], N);
+
+  for (i = 0; i < ORACLE_RUNS; i ++) {
+    t0 = oracle_time();
+    num = oracle_run(of, vl, N);
+    t = oracle_time() - t0;
+    if (t < tmin) tmin = t;
+  }
+  tmin /= num;
+  oracle_dense(d2, idx[0], vl[0], N);
+  for (i = 0; i < ORACLE_RUNS; i ++) {
+    t0 = oracle_time();
+    for (k = 0; k < prods; k ++) oracle_mul(ref[0], u[0], d2, N);
+    t = oracle_time() - t0;
+    if (t < tref) tref = t;
+  }
+
+  printf("{\"kernel\":\"%s\",\"N\":%i,", of->name, N);
+  if (vl == vsp)
+    printf("\"vlen\":%i,", vl[0]);
+  else if (of->type == ORACLE_SPARSE2)
+    printf("\"vlen\":[%i,%i],", vl[0], vl[1]);
+  else
+    printf("\"vlen\":[%i,%i,%i],", vl[0], vl[1], vl[2]);
+  printf("\"cycles\":%llu,\"oracle\":%llu,\"speedup\":%.1f," \
+         "\"unit\":\"%s\"}\n", (unsigned long long) tmin, \
+         (unsigned long long) tref, (tmin > 0) ? (double) tref/tmin : 0.0, \
+         ORACLE_UNIT);
+}
+
+
+// The function <oracle_collect> copies the functions to be tested into the
+// array <of> and returns their number. With the kernel registry, it adds the
+// sparse multiplications of all kernels the processor supports, whereby the
+// sums of two sparse multiplications are only added once per function (see
+// also bench_collect in ring_arith_bench.c).
+
+static int oracle_collect(oracle_func_t *of, char names[][64])
+{
+  int i, n = 0, nf = (int) (sizeof(oracle_funcs)/sizeof(oracle_funcs[0]));
+#if defined(AVRNTRU_DISPATCH)
+  const ring_kernel_t *kern;
+  int j, dup;
+
+  for (i = 0; i < ring_kernel_num(); i ++) {
+    kern = ring_kernel_get(i);
+    if (!kern->supported()) continue;
+    memset(&of[n], 0, sizeof(of[n]));
+    snprintf(names[n], 64, "ring_mul_tern_sparse_%s", kern->name);
+    of[n].name = names[n]; of[n].type = ORACLE_SPARSE; of[n].pad = 7;
+    of[n].sparse = kern->sparse;
+    n ++;
+    for (j = dup = 0; j < n; j ++) dup |= (of[j].sparse2 == kern->sparse2);
+    if (dup) continue;
+    memset(&of[n], 0, sizeof(of[n]));
+    snprintf(names[n], 64, "ring_mul_tern_sparse2_%s", kern->name);
+    of[n].name = names[n]; of[n].type = ORACLE_SPARSE2; of[n].pad = 7;
+    of[n].sparse2 = kern->sparse2;
+    n ++;
+  }
+#else
+  (void) names;
+#endif
+  for (i = 0; i < nf; i ++) {
+    if ((oracle_funcs[i].supported != NULL) && !oracle_funcs[i].supported())
+      continue;
+    of[n++] = oracle_funcs[i];
+  }
+
+  return n;
+}
+
+
+// Differential test of all functions. The sparse products are tested with
+// every number of non-0 coefficients in <vlens> that does not exceed N, the
+// sums of two products with consecutive pairs of them, and the product-form
+// products with the triples in <pf> (which include those of the parameter
+// sets EES401EP2, EES443EP1, and EES743EP1).
+
+int main(void)
+{
+  static const int dims[11] = { 11, 16, 17, 31, 32, 64, 101, 257, 401, 443, \
+                                743 };
+  static const int vlens[6] = { 1, 2, 7, 16, 22, AVRNTRU_MAX_NZC };
+  static const int pf[6][3] = { { 1, 2, 3 }, { 2, 7, 4 }, { 10, 9, 12 }, \
+                                { 16, 16, 12 }, { 18, 16, 10 }, \
+                                { 22, 22, 30 } };
+  oracle_func_t of[48];
+  char names[48][64];
+  int i, j, k, m, n, nf, fail = 0, err, vlen[3];
+
+#ifdef AVRNTRU_USE_THREADS
+  if (ring_pool_init(&oracle_pool, 3) != AVRNTRU_NO_ERROR) return 1;
+#endif
+  nf = oracle_collect(of, names);
+  for (n = 0; n < nf; n ++) {
+    err = 0;
+    for (i = 0; i < 11; i ++) {
+      for (j = 0; j < 6; j ++) {
+        if (of[n].type >= ORACLE_PRODFORM && of[n].type <= ORACLE_PF_MULTI) {
+          for (k = 0; k < 3; k ++) vlen[k] = pf[j][k];
+          if (vlen[0] > dims[i] || vlen[1] > dims[i] || vlen[2] > dims[i])
+            continue;
+        } else {
+          vlen[0] = vlens[j]; vlen[2] = 0;
+          vlen[1] = (of[n].type == ORACLE_SPARSE2) ? vlens[(j+1)%6] : 0;
+          if (vlen[0] > dims[i] || vlen[1] > dims[i]) continue;
+        }
+        for (m = 0; m < 4; m ++) err |= oracle_check(&of[n], vlen, dims[i], m);
+      }
+    }
+    printf("%s vs. schoolbook (N=11..743): %s\n", of[n].name, \
+           err ? "FAILED" : "OK");
+    fail |= err;
+  }
+  for (n = 0; n < nf; n ++) oracle_speedup(&of[n]);
+#ifdef AVRNTRU_USE_THREADS
+  ring_pool_free(&oracle_pool);
+#endif
+
+  return fail;
+}
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_pack.c: Packing of Ring-Elements into Byte-Strings.                  //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "config.h"
+#include "ring_pack.h"
+
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+#include <immintrin.h>
+#endif
+
+
+// The macro TARGET_AVX2 enables AVX2 for a single function when the compiler
+// supports the target attribute (see ring_arith.c).
+
+#if defined(AVRNTRU_X86_TARGETS)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+
+// The function <ring_pack_c99> converts a ring-element a(x), given by an array
+// <a> of N coefficients, into a byte-string of RING_PACKED_LEN(N) bytes, which
+// is written to array <out>. Each coefficient is reduced modulo q and occupies
+// AVRNTRU_LOG_Q bits (e.g. 11 bits for q = 2048), whereby the coefficients are
+// packed in ascending order, starting with the least-significant bit of a_0
+// in the least-significant bit of out[0]. Unused bits of the last byte are set
+// to 0. Thus, a public key or a ciphertext for EES743EP1 needs only 1022 bytes
+// instead of 1486 bytes. The coefficients of a(x) may be unreduced (see the
+// lazy reduction in config.h). Since a(x) is public, the execution time does
+// not need to be constant.
+
+void ring_pack_c99(uint8_t *out, const uint16_t *a, int N)
+{
+  int i, j = 0, bits = 0;
+  uint32_t acc = 0;
+
+  for (i = 0; i < N; i ++) {
+    acc |= ((uint32_t) (a[i] & AVRNTRU_Q_MASK)) << bits;
+    bits += AVRNTRU_LOG_Q;
+    // write all complete bytes of the accumulator
+    while (bits >= 8) {
+      out[j++] = (uint8_t) acc;
+      acc >>= 8;
+      bits -= 8;
+    }
+  }
+  if (bits > 0) out[j] = (uint8_t) acc;
+}
+
+
+// The function <ring_unpack_range> extracts the coefficients a_lo to a_N-1
+// from the byte-string <in> (see ring_pack_c99) and writes them to the array
+// <a>, followed by the seven wrap-around elements a[N+i] = a[i]. The index
+// <lo> must be a multiple of eight so that a_lo starts at a byte boundary.
+
+static void ring_unpack_range(uint16_t *a, const uint8_t *in, int lo, int N)
+{
+  int i, j = (AVRNTRU_LOG_Q*lo)/8, bits = 0;
+  uint32_t acc = 0;
+
+  for (i = lo; i < N; i ++) {
+    // fill the accumulator with at least AVRNTRU_LOG_Q bits
+    while (bits < AVRNTRU_LOG_Q) {
+      acc |= ((uint32_t) in[j++]) << bits;
+      bits += 8;
+    }
+    a[i] = (uint16_t) (acc & AVRNTRU_Q_MASK);
+    acc >>= AVRNTRU_LOG_Q;
+    bits -= AVRNTRU_LOG_Q;
+  }
+  for (i = 0; i < 7; i ++) a[N+i] = a[i];
+}
+
+
+// The function <ring_unpack_c99> is the inverse of <ring_pack_c99>, i.e. it
+// converts the byte-string <in> of RING_PACKED_LEN(N) bytes back into the N
+// coefficients of a(x). The array <a> consists of N+7 elements and gets the
+// layout expected by the multiplication functions, i.e. a[N+i] = a[i] for
+// 0 <= i < 7, which means a packed ciphertext can be unpacked directly into
+// the operand of <ntru_decrypt>. Public keys are unpacked with the function
+// <ntru_pubkey_unpack>, which adds further wrap-around elements if needed.
+
+void ring_unpack_c99(uint16_t *a, const uint8_t *in, int N)
+{
+  ring_unpack_range(a, in, 0, N);
+}
+
+
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+
+// The function <ring_unpack_avx2> is a vectorized implementation of the
+// function <ring_unpack_c99> for x86-64 processors with AVX2 support and
+// q = 2048. A block of eight 11-bit coefficients occupies exactly 11 bytes,
+// which are loaded into both 128-bit lanes of a YMM register. The byte-shuffle
+// places the three bytes containing each coefficient into a 32-bit element,
+// from which the coefficient is extracted by a variable shift and a mask. The
+// eight 32-bit coefficients are then packed into 16-bit words and stored. The
+// last blocks, for which the 16-byte load would exceed the byte-string, are
+// unpacked with the C99 code. For other moduli, the C99 code is used as well.
+
+TARGET_AVX2
+void ring_unpack_avx2(uint16_t *a, const uint8_t *in, int N)
+{
+#if AVRNTRU_LOG_Q == 11
+  int i, len = RING_PACKED_LEN(N);
+  const __m256i shuf = _mm256_setr_epi8(0, 1, 2, -1, 1, 2, 3, -1, 2, 3, 4, \
+    -1, 4, 5, 6, -1, 5, 6, 7, -1, 6, 7, 8, -1, 8, 9, 10, -1, 9, 10, -1, -1);
+  const __m256i shift = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);
+  const __m256i mask = _mm256_set1_epi32(0x07FF);
+  __m256i coef;
+
+  for (i = 0; (i + 8 <= N) && (11*(i/8) + 16 <= len); i += 8) {
+    coef = _mm256_broadcastsi128_si256( \
+           _mm_loadu_si128((const __m128i *) &in[11*(i/8)]));
+    coef = _mm256_shuffle_epi8(coef, shuf);
+    coef = _mm256_and_si256(_mm256_srlv_epi32(coef, shift), mask);
+    // pack the eight 32-bit coefficients into the lower 128 bits
+    coef = _mm256_packus_epi32(coef, coef);
+    coef = _mm256_permute4x64_epi64(coef, 0x08);
+    _mm_storeu_si128((__m128i *) &a[i], _mm256_castsi256_si128(coef));
+  }
+  ring_unpack_range(a, in, i, N);
+#else
+  ring_unpack_range(a, in, 0, N);
+#endif
+}
+
+#endif  // defined(__AVX2__) || ...
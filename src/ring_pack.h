@@ -0,0 +1,39 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_pack.h: Packing of Ring-Elements into Byte-Strings.                  //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_RING_PACK_H
+#define AVRNTRU_RING_PACK_H
+
+#include "typedefs.h"
+#include "config.h"
+
+// Length (in bytes) of a packed ring-element with <N> coefficients modulo q,
+// i.e. each coefficient occupies AVRNTRU_LOG_Q bits (e.g. 11 for q = 2048).
+
+#define RING_PACKED_LEN(N) ((AVRNTRU_LOG_Q*(N) + 7)/8)
+
+// Function prototypes
+
+void ring_pack_c99(uint8_t *out, const uint16_t *a, int N);
+void ring_unpack_c99(uint16_t *a, const uint8_t *in, int N);
+#if defined(__AVX2__) || defined(AVRNTRU_X86_TARGETS)
+void ring_unpack_avx2(uint16_t *a, const uint8_t *in, int N);
+#endif
+
+#endif  // AVRNTRU_RING_PACK_H
@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_tern.c: Bit-Sliced Ternary Polynomials in the NTRU Ring.             //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "config.h"
+#include "ring_tern.h"
+
+
+// The macro INTMASK(x) converts an integer x to an "all-1" mask when x = 1 and
+// to an "all-0" mask when x = 0.
+
+#define INTMASK(x) (~((x) - 1))
+
+
+// A ternary polynomial with N coefficients in {0, 1, -1} is represented by two
+// bit-planes of RING_TERN_WORDS(N) 32-bit words each, whereby the first plane
+// (words 0 to RING_TERN_WORDS(N)-1) holds a "magnitude" bit per coefficient,
+// which is 1 when the coefficient is non-0, and the second plane (the next
+// RING_TERN_WORDS(N) words) holds a "sign" bit per coefficient, which is 1
+// when the coefficient is -1. Bit k of word i of a plane belongs to the
+// coefficient of x^(32*i+k), and the bits beyond x^(N-1) are 0 in both planes.
+// Compared to the "dense" representation of the ring arithmetic (one 16-bit
+// element per coefficient), this saves 87.5% of the RAM, and all operations
+// modulo 3 are carried out on 32 coefficients at once with logical operations.
+
+
+// The following preprocessor directive defines the length of the local arrays
+// <dm> and <ds> in ring_tern_mul_sparse, which hold the planes of the operand
+// twice in a row. Depending on AVRNTRU_USE_VLA, these arrays become either
+// Variable-Length Arrays (VLAs) or static arrays (see config.h).
+
+#ifdef AVRNTRU_USE_VLA
+// Microsoft Visual C does not support VLAs
+#if !(defined(_MSC_VER) && !defined(__ICL))
+#define _dlen (2*RING_TERN_WORDS(N) + 1)
+#else  // static arrays are used
+#define _dlen (2*RING_TERN_WORDS(AVRNTRU_MAX_DIM) + 1)
+#endif
+#endif
+
+
+// The macro TERN_ADD adds two words (am, as) and (bm, bs) of bit-sliced
+// ternary polynomials modulo 3 and writes the magnitude and sign plane of the
+// sum to <rm> and <rs>. A coefficient of the sum is non-0 when exactly one of
+// the two coefficients is non-0, or when both are non-0 and have the same sign
+// (1 + 1 = -1 and -1 - 1 = 1 mod 3), in which case the sign gets inverted.
+// The arguments <am> to <bs> are evaluated more than once, but they are all
+// read before the results are written, so that <rm> and <rs> may be the same
+// as <am> and <as>.
+
+#define TERN_ADD(rm, rs, am, as, bm, bs) do { \
+  uint32_t one_ = (am) ^ (bm); \
+  uint32_t same_ = (am) & (bm) & ~((as) ^ (bs)); \
+  (rm) = one_ | same_; \
+  (rs) = (one_ & ((as) | (bs))) | (same_ & ~(as)); \
+} while (0)
+
+
+// The function <funnel_shift> returns the 32 bits starting at bit <s> of the
+// 64-bit word hi:lo, i.e. (lo >> s) | (hi << (32 - s)) for 0 <= s < 32. Since
+// <s> is derived from the (secret) indices of a sparse polynomial, the shift
+// must have a constant execution time. This is the case for shifts with a
+// variable distance on x86 and ARM, but not on AVR, where avr-gcc implements
+// them with a loop. Therefore, the AVR version is a "barrel shifter" with five
+// stages that shift by 16, 8, 4, 2, and 1 bits, depending on the bits of <s>,
+// whereby the selection is performed with masks instead of branches.
+
+static uint32_t funnel_shift(uint32_t lo, uint32_t hi, int s)
+{
+#if defined(__AVR__)
+  uint32_t mask;
+  int b;
+
+  for (b = 16; b > 0; b >>= 1) {
+    mask = INTMASK((uint32_t) ((s & b) != 0));
+    lo = (lo & ~mask) | (((lo >> b) | (hi << (32 - b))) & mask);
+    hi = (hi & ~mask) | ((hi >> b) & mask);
+  }
+
+  return lo;
+#else
+  // the left-shift is split up to avoid a shift by 32 bits when s = 0
+  return (lo >> s) | ((hi << 1) << (31 - s));
+#endif
+}
+
+
+// The function <ring_tern_from_dense> converts a ternary polynomial a(x) with
+// <N> coefficients in the dense representation of the ring arithmetic (i.e. an
+// array of 16-bit elements being 0, 1, or -1 = 0xFFFF, as produced by e.g.
+// <ring_red_mod3> or <ring_mul_tern_prodform_mod3>) into the bit-sliced
+// representation. The array <t> must consist of RING_TERN_LEN(N) words. The
+// conversion does not contain any branches that depend on the coefficients.
+
+void ring_tern_from_dense(uint32_t *t, const uint16_t *a, int N)
+{
+  int i, w = RING_TERN_WORDS(N);
+  uint32_t mag, sgn;
+
+  for (i = 0; i < 2*w; i ++) t[i] = 0;
+  for (i = 0; i < N; i ++) {
+    mag = ((uint32_t) a[i] + 0xFFFF) >> 16;  // 1 if a[i] != 0
+    sgn = (uint32_t) a[i] >> 15;             // 1 if a[i] = 0xFFFF
+    t[i>>5] |= mag << (i & 31);
+    t[w+(i>>5)] |= sgn << (i & 31);
+  }
+}
+
+
+// The function <ring_tern_to_dense> converts a bit-sliced ternary polynomial
+// into the dense representation, i.e. it writes the <N> coefficients (0, 1, or
+// 0xFFFF) to the array <a>.
+
+void ring_tern_to_dense(uint16_t *a, const uint32_t *t, int N)
+{
+  int i, w = RING_TERN_WORDS(N);
+  uint32_t mag, sgn;
+
+  for (i = 0; i < N; i ++) {
+    mag = (t[i>>5] >> (i & 31)) & 1;
+    sgn = (t[w+(i>>5)] >> (i & 31)) & 1;
+    a[i] = (uint16_t) (mag - 2*(mag & sgn));
+  }
+}
+
+
+// The function <ring_tern_add> computes r(x) = a(x) + b(x) mod 3, whereby all
+// three polynomials are bit-sliced. The arrays may overlap (e.g. r = a).
+
+void ring_tern_add(uint32_t *r, const uint32_t *a, const uint32_t *b, int N)
+{
+  int i, w = RING_TERN_WORDS(N);
+  uint32_t am, as, bm, bs;
+
+  for (i = 0; i < w; i ++) {
+    am = a[i]; as = a[w+i]; bm = b[i]; bs = b[w+i];
+    TERN_ADD(r[i], r[w+i], am, as, bm, bs);
+  }
+}
+
+
+// The function <ring_tern_sub> computes r(x) = a(x) - b(x) mod 3, whereby all
+// three polynomials are bit-sliced. The negation of b(x) amounts to inverting
+// the sign bits of its non-0 coefficients. The arrays may overlap.
+
+void ring_tern_sub(uint32_t *r, const uint32_t *a, const uint32_t *b, int N)
+{
+  int i, w = RING_TERN_WORDS(N);
+  uint32_t am, as, bm, bs;
+
+  for (i = 0; i < w; i ++) {
+    am = a[i]; as = a[w+i]; bm = b[i]; bs = b[w+i] ^ bm;
+    TERN_ADD(r[i], r[w+i], am, as, bm, bs);
+  }
+}
+
+
+// The function <ring_tern_mul_sparse> computes r(x) = r(x) + a(x)*v(x) mod 3
+// in the ring Z_3[x]/(x^N-1), whereby a(x) and r(x) are bit-sliced ternary
+// polynomials and v(x) is a sparse ternary polynomial given by the indices of
+// its non-0 coefficients in the same format as in <ring_mul_tern_sparse> (the
+// first vlen/2 indices belong to the "+1" coefficients and the others to the
+// "-1" coefficients). A product a(x)*v(x) is obtained by adding (resp.
+// subtracting) a(x)*x^k for each index k, and the rotation a(x)*x^k of the
+// bit-planes is realized by extracting N bits at offset N-k from a copy of
+// the planes that contains a(x) twice in a row (arrays <dm> and <ds>), just
+// like the wrap-around elements of the operands in ring_arith.c. Hence, each
+// non-0 coefficient of v(x) costs two funnel shifts and one addition per word
+// instead of N additions of 16-bit coefficients. The rotation accesses the
+// words of <dm> and <ds> at an offset depending on k, which is the same kind
+// of access as in ring_mul_tern_sparse, and the shifts have a constant
+// execution time (see funnel_shift). The array <r> must not overlap <a>.
+
+void ring_tern_mul_sparse(uint32_t *r, const uint32_t *a, const uint16_t *v,
+                          int vlen, int N)
+{
+  int i, j, k, off, w = RING_TERN_WORDS(N);
+  uint32_t dm[_dlen], ds[_dlen], tm, ts, neg, mask;
+
+  // dm and ds hold the magnitude and sign plane of a(x) followed by a(x)*x^N
+  for (i = 0; i < 2*w + 1; i ++) dm[i] = ds[i] = 0;
+  for (i = 0; i < w; i ++) {
+    dm[i] = a[i];
+    ds[i] = a[w+i];
+  }
+  k = N >> 5;
+  for (i = 0; i < w; i ++) {
+    dm[k+i] |= a[i] << (N & 31);
+    ds[k+i] |= a[w+i] << (N & 31);
+    dm[k+i+1] |= (a[i] >> 1) >> (31 - (N & 31));
+    ds[k+i+1] |= (a[w+i] >> 1) >> (31 - (N & 31));
+  }
+
+  for (j = 0; j < vlen; j ++) {
+    // a(x)*x^v[j] consists of the N bits of dm and ds starting at N - v[j]
+    off = N - v[j];
+    k = off >> 5;
+    // the sign bits of the non-0 coefficients are inverted when v_j = -1
+    neg = INTMASK((uint32_t) (j >= vlen/2));
+    for (i = 0; i < w; i ++) {
+      tm = funnel_shift(dm[k+i], dm[k+i+1], off & 31);
+      ts = funnel_shift(ds[k+i], ds[k+i+1], off & 31) ^ (tm & neg);
+      TERN_ADD(r[i], r[w+i], r[i], r[w+i], tm, ts);
+    }
+  }
+
+  // the bits beyond x^(N-1) of the last word are cleared
+  mask = ((uint32_t) 0xFFFFFFFF) >> ((32 - (N & 31)) & 31);
+  r[w-1] &= mask;
+  r[2*w-1] &= mask;
+}
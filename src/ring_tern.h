@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_tern.h: Bit-Sliced Ternary Polynomials in the NTRU Ring.             //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_RING_TERN_H
+#define AVRNTRU_RING_TERN_H
+
+#include "typedefs.h"
+#include "config.h"
+
+// Number of 32-bit words of one bit-plane of a bit-sliced ternary polynomial
+// with <N> coefficients, and number of words of the whole polynomial (i.e. of
+// both bit-planes, see ring_tern.c).
+
+#define RING_TERN_WORDS(N) (((N) + 31) >> 5)
+#define RING_TERN_LEN(N) (2*RING_TERN_WORDS(N))
+
+// Function prototypes
+
+void ring_tern_from_dense(uint32_t *t, const uint16_t *a, int N);
+void ring_tern_to_dense(uint16_t *a, const uint32_t *t, int N);
+void ring_tern_add(uint32_t *r, const uint32_t *a, const uint32_t *b, int N);
+void ring_tern_sub(uint32_t *r, const uint32_t *a, const uint32_t *b, int N);
+void ring_tern_mul_sparse(uint32_t *r, const uint32_t *a, const uint16_t *v,
+                          int vlen, int N);
+
+#endif  // AVRNTRU_RING_TERN_H
@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////////////////////
+// stats.c: Instrumentation of the Hot Paths (Calls, Cycles, Stack).         //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(AVRNTRU_USE_STATS) && !defined(__AVR__)
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+#endif
+
+#include <stdio.h>
+#include "config.h"
+#include "stats.h"
+
+#if defined(AVRNTRU_USE_STATS)
+
+#if defined(__AVR__)
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define STATS_UNIT "cycles"
+#else
+#include <time.h>
+#define STATS_UNIT "ns"
+#endif
+
+
+// On AVR, Timer1 runs freely with a prescaler of 64 once the statistics have
+// been reset, and its overflows are counted by an interrupt service routine,
+// i.e. a time-stamp is the 32-bit concatenation of the overflow counter and
+// TCNT1. Consequently, the elapsed time of a kernel or stage (e.g. the key
+// generation with its dense multiplications) can be up to 2^32 cycles long,
+// and only the total cycles of a kernel or stage wrap around after 2^32. The
+// overflow ISR runs once every 2^22 cycles, which adds a negligible error to
+// the measured times. Timer1 and its overflow interrupt are also used by
+// ring_arith_bench.c, which means the statistics and the benchmark can not be
+// enabled together.
+
+#if defined(__AVR__)
+#define STATS_PRESCALE 64
+#define STATS_UNIT "cycles"
+
+static volatile uint16_t stats_ovf;  // number of timer overflows
+
+
+// Interrupt service routine for the overflow of Timer1, which increments the
+// 16-bit overflow counter.
+
+ISR(TIMER1_OVF_vect)
+{
+  stats_ovf ++;
+}
+#endif
+
+
+// Names of the kernels and stages in the order of their identifiers
+
+static const char *stats_names[AVRNTRU_STAT_NUM] = {
+  "ring_mul_tern_sparse", "ring_mul_tern_sparse2",
+  "ring_mul_tern_sparse_mod3", "ring_mul_tern_sparse_multi", "zero", "copy",
+  "reduce", "ring_mul_tern_prodform", "ntru_encrypt", "ntru_decrypt",
+  "ntru_keygen"
+};
+
+avrntru_stat_t avrntru_stats[AVRNTRU_STAT_NUM];
+
+// Address of a local variable of <avrntru_stats_reset>, which serves as the
+// reference point for the stack depth recorded by <avrntru_stats_stack>.
+
+static uintptr_t stats_stack_base;
+
+
+// The function <avrntru_stats_reset> clears the statistics of all kernels and
+// stages, takes the current stack pointer as reference for the stack depth,
+// and (on AVR) starts Timer1 and enables its overflow interrupt (and thus the
+// interrupts in general). It should be called from the function that then
+// calls the instrumented functions (e.g. main), since the recorded stack depth
+// is relative to the stack frame of <avrntru_stats_reset>. The statistics are
+// not protected by a lock, i.e. they are only meaningful when the instrumented
+// functions are executed by a single thread.
+
+void avrntru_stats_reset(void)
+{
+  volatile uint8_t mark = 0;
+  int i;
+
+  for (i = 0; i < AVRNTRU_STAT_NUM; i ++) {
+    avrntru_stats[i].calls = 0;
+    avrntru_stats[i].cycles = 0;
+    avrntru_stats[i].stack = 0;
+  }
+  stats_stack_base = (uintptr_t) &mark;
+#if defined(__AVR__)
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TCNT1 = 0;
+  stats_ovf = 0;
+  TIFR = _BV(TOV1);
+  TIMSK |= _BV(TOIE1);
+  sei();
+  TCCR1B = _BV(CS11) | _BV(CS10);  // start Timer1 with prescaler 64
+#endif
+}
+
+
+// The function <avrntru_stats_time> returns the current time-stamp, i.e. the
+// overflow counter and the value of Timer1 on AVR, the time-stamp counter on
+// x86 processors, and the monotonic time in nanoseconds on other platforms.
+// On AVR, the two parts are read with interrupts disabled, whereby a pending
+// overflow (i.e. TOV1 is set but the ISR has not been executed yet) is added
+// to the counter when TCNT1 was read after the overflow.
+
+avrntru_cycles_t avrntru_stats_time(void)
+{
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  uint16_t ovf, cnt;
+
+  cli();
+  cnt = TCNT1;
+  ovf = stats_ovf;
+  if ((TIFR & _BV(TOV1)) && (cnt < 0x8000)) ovf ++;
+  SREG = sreg;
+
+  return ((uint32_t) ovf << 16) | cnt;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  return __rdtsc();
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t) ts.tv_sec*1000000000ULL + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+
+// The function <avrntru_stats_add> adds one call and the time elapsed since
+// the time-stamp <start> to the statistics of the kernel or stage <id>.
+
+void avrntru_stats_add(int id, avrntru_cycles_t start)
+{
+  avrntru_cycles_t now = avrntru_stats_time();
+
+  avrntru_stats[id].calls ++;
+#if defined(__AVR__)
+  avrntru_stats[id].cycles += STATS_PRESCALE*(now - start);
+#else
+  avrntru_stats[id].cycles += now - start;
+#endif
+}
+
+
+// The function <avrntru_stats_stack> updates the stack high-water mark of the
+// kernel or stage <id> with the distance between the address <addr> (e.g. of
+// a local array) and the reference point set by <avrntru_stats_reset>. The
+// stack is assumed to grow downwards, which is the case on AVR and x86.
+
+void avrntru_stats_stack(int id, uintptr_t addr)
+{
+  uint32_t depth;
+
+  if ((stats_stack_base == 0) || (addr > stats_stack_base)) return;
+  depth = (uint32_t) (stats_stack_base - addr);
+  if (depth > avrntru_stats[id].stack) avrntru_stats[id].stack = depth;
+}
+
+
+// The function <avrntru_stats_dump> prints the statistics of all kernels and
+// stages that were called at least once, one line per kernel or stage, via
+// printf (i.e. through uart_putch on AVR, just like the functions in utils.c).
+// Each line contains the number of calls, the total and average number of
+// cycles (or nanoseconds), and the stack high-water mark in bytes (0 when the
+// function does not record it).
+
+void avrntru_stats_dump(void)
+{
+  int i;
+  const avrntru_stat_t *s;
+
+  printf("avrntru_stats (" STATS_UNIT "):\n");
+  for (i = 0; i < AVRNTRU_STAT_NUM; i ++) {
+    s = &avrntru_stats[i];
+    if (s->calls == 0) continue;
+#if defined(__AVR__)
+    printf("%s: calls=%lu total=%lu avg=%lu stack=%lu\n", stats_names[i], \
+           (unsigned long) s->calls, (unsigned long) s->cycles, \
+           (unsigned long) (s->cycles/s->calls), (unsigned long) s->stack);
+#else
+    printf("%s: calls=%lu total=%llu avg=%llu stack=%lu\n", stats_names[i], \
+           (unsigned long) s->calls, (unsigned long long) s->cycles, \
+           (unsigned long long) (s->cycles/s->calls), \
+           (unsigned long) s->stack);
+#endif
+  }
+}
+
+#endif  // defined(AVRNTRU_USE_STATS)
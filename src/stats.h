@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// stats.h: Instrumentation of the Hot Paths (Calls, Cycles, Stack).         //
+// This file is part of AVRNTRU, a fast NTRU implementation for 8-bit AVR.   //
+// Version 1.1.0 (2019-04-19), see <http://www.cryptolux.org/> for updates.  //
+// Authors: Johann Groszschaedl and Hao Cheng (University of Luxembourg).    //
+// License: GPLv3 (see LICENSE file), other licenses available upon request. //
+// Copyright (C) 2018-2019 University of Luxembourg <http://www.uni.lu/>     //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AVRNTRU_STATS_H
+#define AVRNTRU_STATS_H
+
+#include "typedefs.h"
+#include "config.h"
+
+// Identifiers of the instrumented kernels and stages. The kernels are counted
+// where the high-level functions call them (and not inside the kernels), so
+// that the statistics do not depend on which version of a kernel is used. The
+// stages ZERO and COPY are the initialization of the temporary arrays and the
+// copying of their wrap-around elements, REDUCE is the final reduction (e.g.
+// ring_add_tern in the encryption), and the remaining ones cover an entire
+// product-form multiplication, encryption, decryption, or key generation.
+
+enum {
+  AVRNTRU_STAT_SPARSE,        // ring_mul_tern_sparse
+  AVRNTRU_STAT_SPARSE2,       // ring_mul_tern_sparse2
+  AVRNTRU_STAT_SPARSE_MOD3,   // ring_mul_tern_sparse_mod3
+  AVRNTRU_STAT_SPARSE_MULTI,  // ring_mul_tern_sparse_multi
+  AVRNTRU_STAT_ZERO,          // initialization of temporary arrays
+  AVRNTRU_STAT_COPY,          // copying of wrap-around elements
+  AVRNTRU_STAT_REDUCE,        // final reduction
+  AVRNTRU_STAT_PRODFORM,      // ring_mul_tern_prodform (all variants)
+  AVRNTRU_STAT_ENCRYPT,       // ntru_encrypt
+  AVRNTRU_STAT_DECRYPT,       // ntru_decrypt
+  AVRNTRU_STAT_KEYGEN,        // ntru_keygen
+  AVRNTRU_STAT_NUM            // number of identifiers
+};
+
+#if defined(AVRNTRU_USE_STATS)
+
+// The type of the time-stamps and accumulated cycles is 32 bits wide on AVR
+// and 64 bits wide on other platforms.
+
+#if defined(__AVR__)
+typedef uint32_t avrntru_cycles_t;
+#else
+typedef uint64_t avrntru_cycles_t;
+#endif
+
+// Struct for the statistics of a kernel or stage: the number of calls, the
+// sum of their cycles, and the maximum depth of the stack (in bytes) measured
+// at the local arrays of the instrumented function.
+
+typedef struct avrntru_stat {
+  uint32_t calls;
+  avrntru_cycles_t cycles;
+  uint32_t stack;
+} avrntru_stat_t;
+
+extern avrntru_stat_t avrntru_stats[AVRNTRU_STAT_NUM];
+
+// Function prototypes
+
+void avrntru_stats_reset(void);
+void avrntru_stats_dump(void);
+avrntru_cycles_t avrntru_stats_time(void);
+void avrntru_stats_add(int id, avrntru_cycles_t start);
+void avrntru_stats_stack(int id, uintptr_t addr);
+
+// The macro AVRNTRU_STATS_CALL(id, stmt) executes the statement <stmt> (e.g.
+// a call of a kernel or a loop) and adds one call and its cycles to the stats
+// of <id>. An entire function is measured by declaring a time-stamp variable
+// with AVRNTRU_STATS_VAR, setting it with AVRNTRU_STATS_START at the beginning
+// and passing it to AVRNTRU_STATS_STOP at the end. AVRNTRU_STATS_STACK(id, p)
+// records the stack depth at the address <p>, which should be the address of
+// the lowest local array of the function.
+
+#define AVRNTRU_STATS_CALL(id, stmt) do { \
+  avrntru_cycles_t stats_start_ = avrntru_stats_time(); \
+  stmt; \
+  avrntru_stats_add((id), stats_start_); \
+} while (0)
+#define AVRNTRU_STATS_VAR(t) avrntru_cycles_t t
+#define AVRNTRU_STATS_START(t) ((t) = avrntru_stats_time())
+#define AVRNTRU_STATS_STOP(id, t) avrntru_stats_add((id), (t))
+#define AVRNTRU_STATS_STACK(id, p) \
+  avrntru_stats_stack((id), (uintptr_t) (p))
+
+#else  // the instrumentation is compiled out
+
+#define AVRNTRU_STATS_CALL(id, stmt) do { stmt; } while (0)
+#define AVRNTRU_STATS_VAR(t)
+#define AVRNTRU_STATS_START(t) ((void) 0)
+#define AVRNTRU_STATS_STOP(id, t) ((void) 0)
+#define AVRNTRU_STATS_STACK(id, p) ((void) 0)
+
+#endif  // defined(AVRNTRU_USE_STATS)
+
+#endif  // AVRNTRU_STATS_H